@@ -1,13 +1,29 @@
 set(headers ${headers}
 	include/Cache.h
+	include/Capture.h
+	include/CaptureFormat.h
+	include/CellIndex.h
+	include/Containers.h
+	include/FormIDSet.h
 	include/FormSwap.h
 	include/FormSwapMap.h
 	include/LODSwap.h
 	include/LandscapeSwap.h
+	include/MemoryUsage.h
+	include/NifScanner.h
+	include/OriginalBases.h
 	include/PCH.h
 	include/Papyrus.h
+	include/Prefetch.h
+	include/Profiler.h
+	include/Scheduler.h
 	include/SeasonManager.h
 	include/Seasons.h
 	include/SnowSwap.h
+	include/SwapLookup.h
+	include/SwapMemo.h
+	include/Trace.h
+	include/Transition.h
 	include/Util.h
+	include/Worker.h
 )
@@ -1,10 +1,21 @@
 set(sources ${sources}
 	src/Cache.cpp
+	src/Capture.cpp
+	src/CellIndex.cpp
 	src/FormSwapMap.cpp
+	src/MemoryUsage.cpp
+	src/NifScanner.cpp
 	src/PCH.cpp
 	src/Papyrus.cpp
+	src/Prefetch.cpp
+	src/Profiler.cpp
+	src/Scheduler.cpp
 	src/SeasonManager.cpp
 	src/Seasons.cpp
 	src/SnowSwap.cpp
+	src/SwapMemo.cpp
+	src/Trace.cpp
+	src/Transition.cpp
+	src/Worker.cpp
 	src/main.cpp
 )
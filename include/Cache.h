@@ -1,5 +1,7 @@
 #pragma once
 
+#include "OriginalBases.h"
+
 namespace Cache
 {
 	class DataHolder
@@ -20,9 +22,13 @@ namespace Cache
 		[[nodiscard]] bool IsSnowShader(const RE::TESForm* a_form) const;
 
 		RE::TESBoundObject* GetOriginalBase(RE::TESObjectREFR* a_ref);
+		//same as GetOriginalBase for each reference, under one lock
+		std::vector<RE::TESBoundObject*> GetOriginalBases(const std::vector<RE::TESObjectREFR*>& a_refs);
 
 		void SetOriginalBase(const RE::TESObjectREFR* a_ref, const RE::TESBoundObject* a_originalBase);
 
+		void GetMemoryUsage(std::vector<memory::TableStats>& a_stats) const;
+
 	protected:
 		DataHolder() = default;
 		DataHolder(const DataHolder&) = delete;
@@ -33,14 +39,11 @@ namespace Cache
 		DataHolder& operator=(DataHolder&&) = delete;
 
 	private:
-		using Lock = std::shared_mutex;
-		using Locker = std::scoped_lock<Lock>;
 		using _GetFormEditorID = const char* (*)(std::uint32_t);
 
 		MapPair<RE::FormID> _textureToLandMap;
 		Set<RE::FormID> _snowShaders;
 
-		mutable Lock _originalsLock;
-		MapPair<RE::FormID> _originals;
+		OriginalBases _originals;
 	};
 }
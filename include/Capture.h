@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CaptureFormat.h"
+#include "Profiler.h"
+
+//Records hook invocations to a binary file, to replay real access patterns against lookup changes
+namespace Capture
+{
+	class Manager
+	{
+	public:
+		static Manager* GetSingleton()
+		{
+			static Manager singleton;
+			return std::addressof(singleton);
+		}
+
+		void LoadSettings(CSimpleIniA& a_ini);
+
+		//writes to po3_SeasonsOfSkyrim_hooks.bin in the log directory
+		void Start();
+		void Stop();
+
+		[[nodiscard]] bool IsCapturing() const
+		{
+			return capturing.load(std::memory_order_relaxed);
+		}
+
+		void AddRecord(Profiler::HOOK a_hook, RE::FormID a_input, RE::FormID a_output, std::uint16_t a_flags = 0, std::int16_t a_x = 0, std::int16_t a_y = 0, std::uint32_t a_scale = 0);
+
+	protected:
+		Manager() = default;
+		Manager(const Manager&) = delete;
+		Manager(Manager&&) = delete;
+		~Manager() = default;
+
+		Manager& operator=(const Manager&) = delete;
+		Manager& operator=(Manager&&) = delete;
+
+	private:
+		using Lock = std::mutex;
+		using Locker = std::scoped_lock<Lock>;
+
+		//each thread appends to its own buffer, full buffers are written out under the file lock
+		struct ThreadBuffer
+		{
+			Lock lock;
+			std::vector<Record> records;
+		};
+
+		ThreadBuffer& GetThreadBuffer();
+		void Write(std::vector<Record>& a_records);
+
+		static constexpr std::size_t bufferSize{ 4096 };
+
+		struct
+		{
+			bool captureOnStartup{ false };
+			std::uint32_t maxRecords{ 4000000 };
+		} settings;
+
+		//start is read by hook threads while a new capture may be starting
+		std::atomic_bool capturing{ false };
+		std::atomic<std::chrono::steady_clock::rep> start{ 0 };
+
+		Lock _buffersLock;
+		std::vector<std::unique_ptr<ThreadBuffer>> _buffers{};
+
+		Lock _fileLock;
+		std::ofstream _file{};
+		std::uint64_t _written{ 0 };
+	};
+
+	//no-op unless a capture is running
+	template <class... Args>
+	void record(Profiler::HOOK a_hook, Args... a_args)
+	{
+		if (const auto manager = Manager::GetSingleton(); manager->IsCapturing()) {
+			manager->AddRecord(a_hook, a_args...);
+		}
+	}
+}
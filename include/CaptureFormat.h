@@ -0,0 +1,36 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+//Hook capture file format, shared with tools/capturereplay (no engine types)
+//File layout : Header, then Records until the end of the file, little endian
+namespace Capture
+{
+	inline constexpr std::array<char, 4> MAGIC{ 'S', 'O', 'S', 'H' };
+	inline constexpr std::uint16_t VERSION{ 1 };
+
+	struct Header
+	{
+		std::array<char, 4> magic{ MAGIC };
+		std::uint16_t version{ VERSION };
+		std::uint16_t recordSize{ 0 };
+		std::uint32_t hookCount{ 0 };  //Profiler::HOOK::kTotal
+		std::uint32_t pad{ 0 };
+	};
+	static_assert(sizeof(Header) == 16);
+
+	struct Record
+	{
+		std::uint64_t timestamp;  //ns since capture start
+		std::uint32_t threadID;
+		std::uint16_t hook;    //Profiler::HOOK
+		std::uint16_t flags;   //LOD : 1 if the seasonal file was used
+		std::uint32_t input;   //base, land texture or texture set formID, or worldspace formID for LOD
+		std::uint32_t output;  //swap formID (0 if unchanged), or reference formID for Clone3D
+		std::int16_t x;        //LOD quad
+		std::int16_t y;
+		std::uint32_t scale;
+	};
+	static_assert(sizeof(Record) == 32);
+}
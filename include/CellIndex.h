@@ -0,0 +1,96 @@
+#pragma once
+
+#include "FormIDSet.h"
+#include "Seasons.h"
+
+//Tracks which exterior cells contain references that can change with the season
+namespace CellIndex
+{
+	struct CellInfo
+	{
+		RE::FormID worldSpace{ 0 };
+		std::int32_t x{ 0 };
+		std::int32_t y{ 0 };
+		std::uint32_t refs{ 0 };
+		std::uint32_t swappableRefs{ 0 };
+		std::uint32_t snowRefs{ 0 };
+		Set<RE::FormID> swappableBases{};  //original bases
+		Set<RE::FormID> snowBases{};
+	};
+
+	struct WorldSpaceStats
+	{
+		std::uint32_t cells{ 0 };
+		std::uint32_t affectedCells{ 0 };
+		std::uint32_t refs{ 0 };
+		std::uint32_t swappableRefs{ 0 };
+		std::uint32_t snowRefs{ 0 };
+	};
+
+	class Manager final : public RE::BSTEventSink<RE::TESCellFullyLoadedEvent>
+	{
+	public:
+		[[nodiscard]] static Manager* GetSingleton()
+		{
+			static Manager singleton;
+			return std::addressof(singleton);
+		}
+
+		//collect bases with a swap in any season, and snow eligible statics
+		void BuildSwappableBases();
+		void Register();
+
+		[[nodiscard]] bool IsSwappableBase(RE::FormID a_base) const;
+		[[nodiscard]] bool IsSnowBase(RE::FormID a_base) const;
+		//prefilter for the hooks : false if a reference with this base can never change base (swap or revert) in any season
+		[[nodiscard]] bool CanChangeBase(RE::FormID a_base) const;
+		//prefilter for the hooks : false if this base never gets snow
+		[[nodiscard]] bool CanHaveSnow(RE::FormID a_base) const;
+
+		//cells that have not been indexed yet count as affected
+		[[nodiscard]] bool IsAffected(const RE::TESObjectCELL* a_cell, const SEASON_DELTA& a_delta, bool a_snowChanged) const;
+		//a_skip : cells left out, like the loaded grid when only the rest of the buffer would be purged
+		[[nodiscard]] bool HasAffectedBufferedCells(const SEASON_DELTA& a_delta, bool a_snowChanged, const Set<RE::FormID>& a_skip = {}) const;
+		void ClearBufferedCells(const Set<RE::FormID>& a_keep = {});
+
+		//swappable bases found in buffered cells
+		[[nodiscard]] Set<RE::FormID> GetBufferedBases() const;
+
+		[[nodiscard]] std::optional<CellInfo> GetCellInfo(RE::FormID a_cell) const;
+		//indexed cells within a_radius cells of a_x, a_y
+		[[nodiscard]] std::vector<CellInfo> GetCellsInGrid(RE::FormID a_worldSpace, std::int32_t a_x, std::int32_t a_y, std::int32_t a_radius) const;
+		[[nodiscard]] Map<RE::FormID, WorldSpaceStats> GetWorldSpaceStats() const;
+		void LogStatistics() const;
+
+		void GetMemoryUsage(std::vector<memory::TableStats>& a_stats) const;
+
+	protected:
+		using EventResult = RE::BSEventNotifyControl;
+
+		EventResult ProcessEvent(const RE::TESCellFullyLoadedEvent* a_event, RE::BSTEventSource<RE::TESCellFullyLoadedEvent>*) override;
+
+	private:
+		Manager() = default;
+		Manager(const Manager&) = delete;
+		Manager(Manager&&) = delete;
+		~Manager() override = default;
+
+		Manager& operator=(const Manager&) = delete;
+		Manager& operator=(Manager&&) = delete;
+
+		using Lock = std::shared_mutex;
+		using Locker = std::scoped_lock<Lock>;
+		using ReadLocker = std::shared_lock<Lock>;
+
+		static bool IsAffected(const CellInfo& a_info, const SEASON_DELTA& a_delta, bool a_snowChanged);
+
+		FormIDSet _swappableBases{};
+		FormIDSet _swapBasesAndTargets{};
+		FormIDSet _snowBases{};
+		std::atomic_bool _built{ false };  //everything passes until then
+
+		mutable Lock _lock;
+		Map<RE::FormID, CellInfo> _cells{};
+		Set<RE::FormID> _bufferedCells{};  //exterior cells loaded since the last purge
+	};
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+//Hash containers used by the plugin's lookup tables.
+//Standalone tests and tools without robin_hood on the include path get the std containers instead
+#if __has_include(<robin_hood.h>)
+#	include <robin_hood.h>
+
+template <class T1, class T2>
+using Map = robin_hood::unordered_flat_map<T1, T2>;
+
+template <class T>
+using MapPair = robin_hood::unordered_flat_map<T, T>;
+
+template <class T>
+using Set = robin_hood::unordered_flat_set<T>;
+#else
+#	include <unordered_map>
+#	include <unordered_set>
+
+template <class T1, class T2>
+using Map = std::unordered_map<T1, T2>;
+
+template <class T>
+using MapPair = std::unordered_map<T, T>;
+
+template <class T>
+using Set = std::unordered_set<T>;
+#endif
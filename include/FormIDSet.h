@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MemoryUsage.h"
+
+//Dense bit set over load order FormIDs, for membership tests on hot paths.
+//Full plugins get one bit per local ID up to the highest inserted, light plugins a 4096 bit block each. Dynamic forms (FF) are never contained.
+//No engine types, also used by tools/capturereplay
+class FormIDSet
+{
+public:
+	using FormID = std::uint32_t;
+
+	void insert(FormID a_formID)
+	{
+		const auto index = a_formID >> 24;
+		if (index < fullPlugins) {
+			const auto localID = a_formID & 0xFFFFFF;
+			auto& words = _full[index];
+			if (words.size() <= localID >> 6) {
+				words.resize((localID >> 6) + 1);
+			}
+			set(words[localID >> 6], localID);
+		} else if (index == 0xFE) {
+			auto& block = _light[(a_formID >> 12) & 0xFFF];
+			if (!block) {
+				block = std::make_unique<LightBlock>();
+			}
+			set((*block)[(a_formID & 0xFFF) >> 6], a_formID);
+		}
+	}
+
+	[[nodiscard]] bool contains(FormID a_formID) const noexcept
+	{
+		const auto index = a_formID >> 24;
+		if (index < fullPlugins) {
+			const auto localID = a_formID & 0xFFFFFF;
+			const auto& words = _full[index];
+			return (localID >> 6) < words.size() && test(words[localID >> 6], localID);
+		}
+		if (index == 0xFE) {
+			const auto& block = _light[(a_formID >> 12) & 0xFFF];
+			return block && test((*block)[(a_formID & 0xFFF) >> 6], a_formID);
+		}
+		return false;
+	}
+
+	void clear()
+	{
+		for (auto& words : _full) {
+			words = {};
+		}
+		for (auto& block : _light) {
+			block.reset();
+		}
+	}
+
+	[[nodiscard]] std::size_t size() const
+	{
+		std::size_t count = 0;
+		for (const auto& words : _full) {
+			for (const auto& word : words) {
+				count += std::popcount(word);
+			}
+		}
+		for (const auto& block : _light) {
+			if (block) {
+				for (const auto& word : *block) {
+					count += std::popcount(word);
+				}
+			}
+		}
+		return count;
+	}
+
+	[[nodiscard]] memory::TableStats get_stats(std::string a_name) const
+	{
+		memory::TableStats stats{ std::move(a_name), size() };
+
+		stats.bytes = sizeof(*this);
+		for (const auto& words : _full) {
+			stats.buckets += words.size() * 64;
+			stats.bytes += words.capacity() * sizeof(std::uint64_t);
+		}
+		for (const auto& block : _light) {
+			if (block) {
+				stats.buckets += lightBits;
+				stats.bytes += sizeof(LightBlock);
+			}
+		}
+		stats.loadFactor = stats.buckets ? static_cast<float>(stats.entries) / static_cast<float>(stats.buckets) : 0.0f;
+
+		return stats;
+	}
+
+private:
+	static constexpr std::size_t fullPlugins{ 0xFE };
+	static constexpr std::size_t lightBits{ 0x1000 };
+
+	using LightBlock = std::array<std::uint64_t, lightBits / 64>;
+
+	static void set(std::uint64_t& a_word, FormID a_localID)
+	{
+		a_word |= std::uint64_t(1) << (a_localID & 63);
+	}
+
+	static bool test(std::uint64_t a_word, FormID a_localID)
+	{
+		return (a_word >> (a_localID & 63)) & 1;
+	}
+
+	std::array<std::vector<std::uint64_t>, fullPlugins> _full{};
+	std::array<std::unique_ptr<LightBlock>, 0x1000> _light{};
+};
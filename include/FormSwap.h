@@ -1,20 +1,133 @@
 #pragma once
 
+#include "Capture.h"
+#include "CellIndex.h"
+#include "Prefetch.h"
+#include "Profiler.h"
 #include "SeasonManager.h"
+#include "SwapMemo.h"
 
 namespace FormSwap
 {
 	struct detail
 	{
-		static RE::TESBoundObject* get_form_swap(RE::TESObjectREFR* a_ref, const RE::TESBoundObject* a_base)
+		static bool is_valid_ref(const RE::TESObjectREFR* a_ref)
 		{
+			return a_ref && !a_ref->IsDynamicForm() && !a_ref->IsDeleted() && !a_ref->IsDisabled();
+		}
+
+		static SwapMemo::Decision get_decision(RE::TESBoundObject* a_base, RE::TESBoundObject* a_origBase)
+		{
+			const auto seasonManager = SeasonManager::GetSingleton();
+
+			const auto replaceBase = a_origBase && seasonManager->CanSwapForm(a_base->GetFormType()) ? seasonManager->GetSwapForm(a_origBase) : nullptr;
+			if (replaceBase) {
+				return { a_base->GetFormID(), replaceBase, replaceBase != a_base };
+			}
+			if (a_origBase && a_origBase != a_base) {
+				return { a_base->GetFormID(), a_origBase, false };
+			}
+			return { a_base->GetFormID(), a_base, false };
+		}
+
+		//returns true if the base object was changed
+		static bool apply_decision(RE::TESObjectREFR* a_ref, RE::TESBoundObject* a_base, const SwapMemo::Decision& a_decision)
+		{
+			if (a_decision.target == a_base) {
+				return false;
+			}
+
+			if (a_decision.recordOriginal) {
+				util::set_original_base(a_ref, a_base);
+			}
+			a_ref->SetObjectReference(a_decision.target);
+			return true;
+		}
+
+		//decides every reference in the cell up front, if at least a_minRefs can change base. References are grouped by base, so each base and original is resolved once
+		static void resolve_cell(RE::TESObjectCELL* a_cell, std::uint32_t a_epoch, std::uint32_t a_minRefs)
+		{
+			const auto cellIndex = CellIndex::Manager::GetSingleton();
+
+			std::vector<RE::TESObjectREFR*> refs;
+			a_cell->ForEachReference([&](RE::TESObjectREFR& a_ref) {
+				if (const auto base = is_valid_ref(&a_ref) ? a_ref.GetBaseObject() : nullptr; base && cellIndex->CanChangeBase(base->GetFormID())) {
+					refs.push_back(&a_ref);
+				}
+				return RE::BSContainer::ForEachResult::kContinue;
+			});
+
+			//sorting and grouping costs more than it saves on smaller cells, their references are resolved one at a time
+			if (refs.size() < a_minRefs) {
+				return;
+			}
+
+			std::ranges::sort(refs, {}, [](const RE::TESObjectREFR* a_ref) { return a_ref->GetBaseObject()->GetFormID(); });
+
+			const auto origBases = Cache::DataHolder::GetSingleton()->GetOriginalBases(refs);
+
+			SwapMemo::Decisions decisions;
+			decisions.reserve(refs.size());
+
+			const auto uniqueBases = SwapMemo::decide_grouped(
+				refs, origBases,
+				[](const RE::TESObjectREFR* a_ref) { return a_ref->GetFormID(); },
+				[](const RE::TESObjectREFR* a_ref) { return a_ref->GetBaseObject(); },
+				get_decision, decisions);
+
+			const auto memo = SwapMemo::Manager::GetSingleton();
+			memo->Record(decisions, a_epoch);
+			memo->CountCell(refs.size(), uniqueBases);
+		}
+
+		static bool resolve_base(RE::TESObjectREFR* a_ref, RE::TESBoundObject* a_base)
+		{
+			return apply_decision(a_ref, a_base, get_decision(a_base, util::get_original_base(a_ref)));
+		}
+
+		//returns true if the base object was changed
+		static bool update_base(RE::TESObjectREFR* a_ref)
+		{
+			const auto base = is_valid_ref(a_ref) ? a_ref->GetBaseObject() : nullptr;
+			if (!base || !CellIndex::Manager::GetSingleton()->CanChangeBase(base->GetFormID())) {
+				return false;
+			}
+
 			const auto seasonManager = SeasonManager::GetSingleton();
 
-			if (const auto origBase = seasonManager->CanSwapForm(a_base->GetFormType()) ? util::get_original_base(a_ref) : nullptr; origBase) {
-				return seasonManager->GetSwapForm(origBase);
+			const auto epoch = seasonManager->GetStateEpoch();
+			if (epoch == 0) {
+				return resolve_base(a_ref, base);
+			}
+
+			const auto memo = SwapMemo::Manager::GetSingleton();
+			const auto refID = a_ref->GetFormID();
+
+			auto decision = memo->Find(refID, epoch);
+			if (const auto cellBatchRefs = seasonManager->GetCellBatchRefs(); !decision && cellBatchRefs > 0) {
+				if (const auto cell = a_ref->GetParentCell(); cell && memo->BeginCell(cell->GetFormID(), epoch)) {
+					resolve_cell(cell, epoch, cellBatchRefs);
+					decision = memo->Find(refID, epoch);
+				}
+			}
+
+			//decided under this season state, for the base the reference still has
+			if (decision && (decision->target == base || decision->base == base->GetFormID())) {
+				memo->CountLookup(refID, true);
+
+				const bool changed = apply_decision(a_ref, base, *decision);
+				if (changed) {
+					memo->Record(refID, { decision->target->GetFormID(), decision->target, false }, epoch);
+				}
+				return changed;
 			}
 
-			return nullptr;
+			memo->CountLookup(refID, false);
+
+			const bool changed = resolve_base(a_ref, base);
+			memo->Record(refID, { a_ref->GetBaseObject()->GetFormID(), a_ref->GetBaseObject(), false }, epoch);
+
+			return changed;
 		}
 	};
 
@@ -22,15 +135,18 @@ namespace FormSwap
 	{
 		static RE::RefHandle& thunk(RE::TESObjectREFR* a_ref, RE::RefHandle& a_handle)
 		{
-			const auto base = a_ref && !a_ref->IsDynamicForm() && !a_ref->IsDeleted() && !a_ref->IsDisabled() ? a_ref->GetBaseObject() :
-                                                                                                                nullptr;
-			if (a_ref && base) {
-				if (const auto replaceBase = detail::get_form_swap(a_ref, base); replaceBase) {
-					util::set_original_base(a_ref, base);
-					a_ref->SetObjectReference(replaceBase);
-				} else if (const auto origBase = util::get_original_base(a_ref); origBase && origBase != base) {
-					a_ref->SetObjectReference(origBase);
-				}
+			PROFILE_HOOK(Profiler::HOOK::kGetHandle);
+
+			const auto capture = Capture::Manager::GetSingleton();
+			const auto oldBase = capture->IsCapturing() && a_ref ? a_ref->GetBaseObject() : nullptr;
+
+			const bool swapped = detail::update_base(a_ref);
+			if (swapped) {
+				Prefetch::Manager::GetSingleton()->RecordSwappedLoad(a_ref->GetBaseObject());
+			}
+
+			if (oldBase) {
+				capture->AddRecord(Profiler::HOOK::kGetHandle, oldBase->GetFormID(), swapped ? a_ref->GetBaseObject()->GetFormID() : 0);
 			}
 
 			return func(a_ref, a_handle);
@@ -49,6 +49,22 @@ public:
 		return it != _formMap.end() ? it->second : _nullMap;
 	}
 
+	void GetMemoryUsage(const std::string& a_season, std::vector<memory::TableStats>& a_stats) const;
+
+	//base -> swap pairs of all object sections (land textures excluded)
+	template <class F>
+	void for_each_swap(F&& a_func) const
+	{
+		for (const auto& [type, formMap] : _formMap) {
+			if (type == "LandTextures"sv) {
+				continue;
+			}
+			for (const auto& [base, swap] : formMap) {
+				a_func(base, swap);
+			}
+		}
+	}
+
 private:
 	friend class SeasonManager;
 
@@ -1,17 +1,63 @@
 #pragma once
 
+#include "Capture.h"
+#include "Profiler.h"
 #include <Seasons.h>
 
 namespace LODSwap
 {
 	struct detail
 	{
+		static constexpr Profiler::HOOK get_profiler_hook(LOD_TYPE a_type)
+		{
+			switch (a_type) {
+			case LOD_TYPE::kTerrain:
+				return Profiler::HOOK::kTerrainLOD;
+			case LOD_TYPE::kObject:
+				return Profiler::HOOK::kObjectLOD;
+			default:
+				return Profiler::HOOK::kTreeLOD;
+			}
+		}
+
 		template <class T>
-		static std::string get_lod_filename()
+		static std::string get_lod_filename(std::int16_t a_x = 0, std::int16_t a_y = 0, std::uint32_t a_scale = 0)
 		{
+			PROFILE_HOOK(get_profiler_hook(T::type));
+
 			const auto [canSwap, season] = SeasonManager::GetSingleton()->CanSwapLOD(T::type);
+
+			if (Capture::Manager::GetSingleton()->IsCapturing()) {
+				const auto worldSpace = RE::TES::GetSingleton()->worldSpace;
+				Capture::record(get_profiler_hook(T::type), worldSpace ? worldSpace->GetFormID() : 0, 0, static_cast<std::uint16_t>(canSwap), a_x, a_y, a_scale);
+			}
+
 			return canSwap ? fmt::format(T::seasonalPath, season) : T::defaultPath;
 		}
+
+		//worldspace wide files (atlases, tree lists)
+		template <class T>
+		static std::string get_seasonal_lod_filename(const std::string& a_suffix, const char* a_worldSpace)
+		{
+			const auto path = fmt::format(T::seasonalPath, a_suffix);
+
+			std::array<char, MAX_PATH> buffer{};
+			sprintf_s(buffer.data(), buffer.size(), path.c_str(), a_worldSpace, a_worldSpace);
+
+			return buffer.data();
+		}
+
+		//per quad files
+		template <class T>
+		static std::string get_seasonal_lod_filename(const std::string& a_suffix, const char* a_worldSpace, std::int32_t a_x, std::int32_t a_y, std::uint32_t a_scale)
+		{
+			const auto path = fmt::format(T::seasonalPath, a_suffix);
+
+			std::array<char, MAX_PATH> buffer{};
+			sprintf_s(buffer.data(), buffer.size(), path.c_str(), a_worldSpace, a_worldSpace, a_scale, a_x, a_y);
+
+			return buffer.data();
+		}
 	};
 
 	namespace Terrain
@@ -20,7 +66,7 @@ namespace LODSwap
 		{
 			static void func(char* a_buffer, std::uint32_t a_sizeOfBuffer, const char* a_worldSpace, std::int16_t a_x, std::int16_t a_y, std::uint32_t a_scale)
 			{
-				const auto path = detail::get_lod_filename<BuildMeshFileName>();
+				const auto path = detail::get_lod_filename<BuildMeshFileName>(a_x, a_y, a_scale);
 				sprintf_s(a_buffer, a_sizeOfBuffer, path.c_str(), a_worldSpace, a_worldSpace, a_scale, a_x, a_y);
 			}
 
@@ -37,7 +83,7 @@ namespace LODSwap
 		{
 			static void func(char* a_buffer, std::uint32_t a_sizeOfBuffer, const char* a_worldSpace, std::int16_t a_x, std::int16_t a_y, std::uint32_t a_scale)
 			{
-				const auto path = detail::get_lod_filename<BuildDiffuseTextureFileName>();
+				const auto path = detail::get_lod_filename<BuildDiffuseTextureFileName>(a_x, a_y, a_scale);
 				sprintf_s(a_buffer, a_sizeOfBuffer, path.c_str(), a_worldSpace, a_worldSpace, a_scale, a_x, a_y);
 			}
 
@@ -54,7 +100,7 @@ namespace LODSwap
 		{
 			static void func(char* a_buffer, std::uint32_t a_sizeOfBuffer, const char* a_worldSpace, std::int16_t a_x, std::int16_t a_y, std::uint32_t a_scale)
 			{
-				const auto path = detail::get_lod_filename<BuildNormalTextureFileName>();
+				const auto path = detail::get_lod_filename<BuildNormalTextureFileName>(a_x, a_y, a_scale);
 				sprintf_s(a_buffer, a_sizeOfBuffer, path.c_str(), a_worldSpace, a_worldSpace, a_scale, a_x, a_y);
 			}
 
@@ -81,7 +127,7 @@ namespace LODSwap
 		{
 			static void func(char* a_buffer, std::uint32_t a_sizeOfBuffer, const char* a_worldSpace, std::int16_t a_x, std::int16_t a_y, std::uint32_t a_scale)
 			{
-				const auto path = detail::get_lod_filename<BuildMeshFileName>();
+				const auto path = detail::get_lod_filename<BuildMeshFileName>(a_x, a_y, a_scale);
 				sprintf_s(a_buffer, a_sizeOfBuffer, path.c_str(), a_worldSpace, a_worldSpace, a_scale, a_x, a_y);
 			}
 
@@ -142,7 +188,7 @@ namespace LODSwap
 		{
 			static void func(char* a_buffer, std::uint32_t a_sizeOfBuffer, const char* a_worldSpace, std::int16_t a_x, std::int16_t a_y, std::uint32_t a_scale)
 			{
-				const auto path = detail::get_lod_filename<BuildMeshFileName>();
+				const auto path = detail::get_lod_filename<BuildMeshFileName>(a_x, a_y, a_scale);
 				sprintf_s(a_buffer, a_sizeOfBuffer, path.c_str(), a_worldSpace, a_worldSpace, a_scale, a_x, a_y);
 			}
 
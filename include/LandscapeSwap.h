@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Capture.h"
+#include "Profiler.h"
 #include "SeasonManager.h"
 
 namespace LandscapeSwap
@@ -12,9 +14,18 @@ namespace LandscapeSwap
 		{
 			static float thunk(const RE::TESLandTexture* a_LT)
 			{
+				PROFILE_HOOK(Profiler::HOOK::kIsConsideredSnow);
+
 				const auto manager = SeasonManager::GetSingleton();
 
+				if (const auto data = manager->GetLandTextureData(a_LT)) {
+					Capture::record(Profiler::HOOK::kIsConsideredSnow, a_LT->GetFormID(), data->swapID);
+					return data->isSnow;
+				}
+
 				const auto swapLT = manager->CanSwapLandscape() ? manager->GetSwapLandTexture(a_LT) : a_LT;
+				Capture::record(Profiler::HOOK::kIsConsideredSnow, a_LT->GetFormID(), swapLT && swapLT != a_LT ? swapLT->GetFormID() : 0);
+
 				return swapLT ? swapLT->shaderTextureIndex != 0 : a_LT->shaderTextureIndex != 0;
 			}
 			static inline REL::Relocation<decltype(thunk)> func;
@@ -36,9 +47,18 @@ namespace LandscapeSwap
 		{
 			static float thunk(const RE::TESLandTexture* a_LT)
 			{
+				PROFILE_HOOK(Profiler::HOOK::kGetSpecularComponent);
+
 				const auto manager = SeasonManager::GetSingleton();
 
+				if (const auto data = manager->GetLandTextureData(a_LT)) {
+					Capture::record(Profiler::HOOK::kGetSpecularComponent, a_LT->GetFormID(), data->swapID);
+					return data->specularExponent;
+				}
+
 				const auto swapLT = manager->CanSwapLandscape() ? manager->GetSwapLandTexture(a_LT) : nullptr;
+				Capture::record(Profiler::HOOK::kGetSpecularComponent, a_LT->GetFormID(), swapLT ? swapLT->GetFormID() : 0);
+
 				return swapLT ? swapLT->specularExponent : a_LT->specularExponent;
 			}
 			static inline REL::Relocation<decltype(thunk)> func;
@@ -59,9 +79,18 @@ namespace LandscapeSwap
 		{
 			static RE::BSTextureSet* thunk(RE::BGSTextureSet* a_txst)
 			{
+				PROFILE_HOOK(Profiler::HOOK::kGetAsShaderTextureSet);
+
 				const auto manager = SeasonManager::GetSingleton();
 
+				if (const auto data = manager->GetLandTextureData(a_txst)) {
+					Capture::record(Profiler::HOOK::kGetAsShaderTextureSet, a_txst->GetFormID(), data->swapID);
+					return data->swapID ? data->swapTextureSet : a_txst;
+				}
+
 				const auto swapLT = manager->CanSwapLandscape() ? manager->GetSwapLandTexture(a_txst) : nullptr;
+				Capture::record(Profiler::HOOK::kGetAsShaderTextureSet, a_txst ? a_txst->GetFormID() : 0, swapLT ? swapLT->GetFormID() : 0);
+
 				return swapLT ? swapLT->textureSet : a_txst;
 			}
 			static inline REL::Relocation<decltype(thunk)> func;
@@ -93,11 +122,21 @@ namespace LandscapeSwap
 		{
 			static RE::BSSimpleList<RE::TESGrass*>& func(RE::TESLandTexture* a_landTexture)
 			{
+				PROFILE_HOOK(Profiler::HOOK::kGetGrassList);
+
+				//the table only carries the swapped grass list when the season swaps grass
+				if (const auto data = SeasonManager::GetSingleton()->GetLandTextureData(a_landTexture)) {
+					Capture::record(Profiler::HOOK::kGetGrassList, a_landTexture->GetFormID(), data->swapID);
+					return *data->grassList;
+				}
+
 				if (const auto seasonManager = SeasonManager::GetSingleton(); seasonManager->CanSwapGrass()) {
 					const auto swapLandTexture = seasonManager->GetSwapLandTexture(a_landTexture);
+					Capture::record(Profiler::HOOK::kGetGrassList, a_landTexture->GetFormID(), swapLandTexture ? swapLandTexture->GetFormID() : 0);
 
 					return swapLandTexture ? swapLandTexture->textureGrassList : a_landTexture->textureGrassList;
 				}
+				Capture::record(Profiler::HOOK::kGetGrassList, a_landTexture->GetFormID(), 0);
 				return a_landTexture->textureGrassList;
 			}
 
@@ -117,12 +156,21 @@ namespace LandscapeSwap
 		{
 			static RE::MATERIAL_ID func(const RE::TESLandTexture* a_landTexture)
 			{
+				PROFILE_HOOK(Profiler::HOOK::kGetHavokMaterialType);
+
+				if (const auto data = SeasonManager::GetSingleton()->GetLandTextureData(a_landTexture)) {
+					Capture::record(Profiler::HOOK::kGetHavokMaterialType, a_landTexture->GetFormID(), data->swapID);
+					return data->materialID;
+				}
+
 				if (const auto seasonManager = SeasonManager::GetSingleton(); seasonManager->CanSwapLandscape()) {
 					const auto newLandTexture = seasonManager->GetSwapLandTexture(a_landTexture);
+					Capture::record(Profiler::HOOK::kGetHavokMaterialType, a_landTexture->GetFormID(), newLandTexture ? newLandTexture->GetFormID() : 0);
 					const auto materialType = newLandTexture ? newLandTexture->materialType : a_landTexture->materialType;
 
 					return materialType ? materialType->materialID : RE::MATERIAL_ID::kNone;
 				}
+				Capture::record(Profiler::HOOK::kGetHavokMaterialType, a_landTexture->GetFormID(), 0);
 				return a_landTexture->materialType ? a_landTexture->materialType->materialID : RE::MATERIAL_ID::kNone;
 			}
 
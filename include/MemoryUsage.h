@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+//Entry counts and footprint of the plugin's lookup tables
+namespace memory
+{
+	struct TableStats
+	{
+		std::string name;
+		std::size_t entries{ 0 };
+		std::size_t buckets{ 0 };
+		std::size_t bytes{ 0 };  //table storage plus heap owned by string keys
+		float loadFactor{ 0.0f };
+	};
+
+	template <class T>
+	std::size_t heap_bytes(const T&)
+	{
+		return 0;
+	}
+
+	inline std::size_t heap_bytes(const std::string& a_str)
+	{
+		return a_str.capacity() > 15 ? a_str.capacity() + 1 : 0;  //outside the small string buffer
+	}
+
+	template <class... T>
+	std::size_t heap_bytes(const std::variant<T...>& a_variant)
+	{
+		return std::visit([](const auto& a_value) { return heap_bytes(a_value); }, a_variant);
+	}
+
+	//robin_hood flat tables, one info byte per slot and up to 0xFF overflow slots.
+	//Standalone builds on std tables (see Containers.h) count a pointer per bucket and a node per entry
+	template <class T>
+	TableStats get_table_stats(std::string a_name, const T& a_table)
+	{
+		TableStats stats{ std::move(a_name), a_table.size() };
+
+		if (a_table.size() > 0) {
+			stats.loadFactor = a_table.load_factor();
+
+			if constexpr (requires { a_table.mask(); }) {
+				stats.buckets = a_table.mask() + 1;
+
+				const auto slots = stats.buckets + std::min<std::size_t>(stats.buckets * 80 / 100, 0xFF);
+				stats.bytes = slots * (sizeof(typename T::value_type) + 1) + sizeof(std::uint64_t);
+			} else {
+				stats.buckets = a_table.bucket_count();
+				stats.bytes = stats.buckets * sizeof(void*) + a_table.size() * (sizeof(typename T::value_type) + sizeof(void*));
+			}
+
+			for (const auto& value : a_table) {
+				if constexpr (requires { value.first; }) {
+					stats.bytes += heap_bytes(value.first);
+				} else {
+					stats.bytes += heap_bytes(value);
+				}
+			}
+		}
+
+		return stats;
+	}
+
+	//for many small tables of the same kind, reported as one
+	inline void accumulate(TableStats& a_total, const TableStats& a_stats)
+	{
+		a_total.entries += a_stats.entries;
+		a_total.buckets += a_stats.buckets;
+		a_total.bytes += a_stats.bytes;
+		a_total.loadFactor = a_total.buckets ? static_cast<float>(a_total.entries) / static_cast<float>(a_total.buckets) : 0.0f;
+	}
+
+	template <class T>
+	TableStats get_vector_stats(std::string a_name, const std::vector<T>& a_vector)
+	{
+		return { std::move(a_name), a_vector.size(), a_vector.capacity(), a_vector.capacity() * sizeof(T), a_vector.capacity() ? static_cast<float>(a_vector.size()) / static_cast<float>(a_vector.capacity()) : 0.0f };
+	}
+
+	//every table owned by the plugin
+	std::vector<TableStats> get_plugin_stats();
+	void log_plugin_stats();
+}
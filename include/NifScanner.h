@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+//Reads the NIF block structure directly, without the engine (and without building a scenegraph)
+//Mirrors the checks done in SnowSwap::Manager::GetSnowType
+namespace NifScanner
+{
+	enum class RESULT : std::uint32_t
+	{
+		kUnknown = 0,  //unsupported version/block types, let the engine decide
+		kSinglePass,
+		kMultiPass
+	};
+
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		explicit MappedFile(const std::filesystem::path& a_path);
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&& a_rhs) noexcept;
+		~MappedFile();
+
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&& a_rhs) noexcept;
+
+		[[nodiscard]] bool is_open() const { return _data != nullptr; }
+		[[nodiscard]] std::span<const std::byte> data() const { return { _data, _size }; }
+
+	private:
+		void close();
+
+		const std::byte* _data{ nullptr };
+		std::size_t _size{ 0 };
+#ifdef _WIN32
+		void* _file{ nullptr };
+		void* _mapping{ nullptr };
+#endif
+	};
+
+	[[nodiscard]] RESULT Scan(std::span<const std::byte> a_data);
+	[[nodiscard]] RESULT Scan(const std::filesystem::path& a_path);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "Containers.h"
+#include "MemoryUsage.h"
+
+//Original base of every reference that was swapped, read from loader threads on each queued reference.
+//Lookups share the lock, only inserts take it exclusively. No engine types, also used by tests/contention
+class OriginalBases
+{
+public:
+	using FormID = std::uint32_t;
+
+	//original base formID, or 0 if the reference was never swapped
+	[[nodiscard]] FormID find(FormID a_ref) const
+	{
+		ReadLocker locker(_lock);
+
+		const auto it = _map.find(a_ref);
+		return it != _map.end() ? it->second : 0;
+	}
+
+	//find for each reference under one lock, a_getID returns the reference formID of an element
+	template <class T, class Func>
+	[[nodiscard]] std::vector<FormID> find(const std::vector<T>& a_refs, Func&& a_getID) const
+	{
+		std::vector<FormID> result;
+		result.reserve(a_refs.size());
+
+		ReadLocker locker(_lock);
+
+		for (const auto& ref : a_refs) {
+			const auto it = _map.find(a_getID(ref));
+			result.push_back(it != _map.end() ? it->second : 0);
+		}
+
+		return result;
+	}
+
+	//the first original is kept
+	void emplace(FormID a_ref, FormID a_originalBase)
+	{
+		Locker locker(_lock);
+
+		_map.emplace(a_ref, a_originalBase);
+	}
+
+	[[nodiscard]] memory::TableStats get_stats(std::string a_name) const
+	{
+		ReadLocker locker(_lock);
+
+		return memory::get_table_stats(std::move(a_name), _map);
+	}
+
+private:
+	using Lock = std::shared_mutex;
+	using Locker = std::scoped_lock<Lock>;
+	using ReadLocker = std::shared_lock<Lock>;
+
+	mutable Lock _lock;
+	MapPair<FormID> _map;
+};
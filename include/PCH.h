@@ -7,10 +7,14 @@
 
 #include <ShlObj.h>
 #include <SimpleIni.h>
+#include <bit>
+#include <bitset>
+#include <condition_variable>
 #include <fmt/format.h>
+#include <fstream>
 #include <ranges>
-#include <robin_hood.h>
 #include <shared_mutex>
+#include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <xbyak/xbyak.h>
 
@@ -57,14 +61,7 @@ namespace stl
 	}
 }
 
-template <class T1, class T2>
-using Map = robin_hood::unordered_flat_map<T1, T2>;
-
-template <class T>
-using MapPair = robin_hood::unordered_flat_map<T, T>;
-
-template <class T>
-using Set = robin_hood::unordered_flat_set<T>;
+#include "Containers.h"
 
 #ifdef SKYRIM_AE
 #	define OFFSET(se, ae) ae
@@ -77,6 +74,7 @@ using Set = robin_hood::unordered_flat_set<T>;
 #	define OFFSET_3(se, ae, vr) se
 #endif
 
+#include "MemoryUsage.h"
 #include "Cache.h"
 #include "Util.h"
 #include "Version.h"
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Seasons.h"
+#include "Worker.h"
+
+//Reads the next season's files ahead of the month boundary, so the switch itself is served from cache
+namespace Prefetch
+{
+	class Manager
+	{
+	public:
+		static Manager* GetSingleton()
+		{
+			static Manager singleton;
+			return std::addressof(singleton);
+		}
+
+		void LoadSettings(CSimpleIniA& a_ini);
+
+		//runs every frame through the scheduler
+		void Register();
+
+		//called on a door activation that changes the season, while the loading screen is up
+		void PrefetchDestination(SEASON a_currentSeason, SEASON a_nextSeason, const RE::TESWorldSpace* a_worldSpace, const RE::NiPoint3& a_pos);
+
+		//called when a reference is queued with a swapped base
+		void RecordSwappedLoad(const RE::TESBoundObject* a_swapBase);
+
+		void GetMemoryUsage(std::vector<memory::TableStats>& a_stats) const;
+
+	protected:
+		Manager() = default;
+		Manager(const Manager&) = delete;
+		Manager(Manager&&) = delete;
+		~Manager() = default;
+
+		Manager& operator=(const Manager&) = delete;
+		Manager& operator=(Manager&&) = delete;
+
+	private:
+		void Update();
+
+		void Start(SEASON a_currentSeason, SEASON a_nextSeason);
+		void Read(std::vector<std::string> a_paths, std::string a_reason);
+
+		static void CollectModels(SEASON a_nextSeason, const SEASON_DELTA& a_delta, const Set<RE::FormID>& a_bases, std::vector<std::string>& a_paths);
+		static void CollectLandTextures(SEASON a_nextSeason, const SEASON_DELTA& a_delta, std::vector<std::string>& a_paths);
+		static void CollectLOD(SEASON a_season, const RE::TESWorldSpace* a_worldSpace, const RE::NiPoint3& a_pos, std::vector<std::string>& a_paths);
+
+		//loads the swap target models of a_bases into the model database on the preload worker
+		void StartPreload(SEASON a_season, const Set<RE::FormID>& a_bases);
+
+		using Lock = std::shared_mutex;
+		using Locker = std::scoped_lock<Lock>;
+		using ReadLocker = std::shared_lock<Lock>;
+
+		struct
+		{
+			float hours{ 12.0f };  //game hours before the season changes
+			bool preloadModels{ false };
+		} settings;
+
+		std::chrono::steady_clock::time_point lastCheck{};
+		SEASON prefetchedSeason{ SEASON::kNone };
+		std::atomic_bool running{ false };
+
+		//swap target models of the cells about to load, held in the model database until the next preload
+		std::atomic_bool preloading{ false };
+
+		mutable Lock _preloadLock;
+		Set<RE::FormID> _preloadedBases{};
+		std::vector<RE::NiPointer<RE::NiNode>> _preloadedModels{};
+
+		std::atomic_uint32_t _warmLoads{ 0 };
+		std::atomic_uint32_t _coldLoads{ 0 };
+
+		//last, so they are joined before the state their jobs touch is destroyed
+		Worker _reader{ "Prefetch" };
+		Worker _preloader{ "Preload" };
+	};
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#ifdef SOS_PROFILER
+#	include <intrin.h>
+#endif
+
+//Per hook call counts and latency histograms. Only compiled in with the ENABLE_PROFILER cmake option
+namespace Profiler
+{
+	enum class HOOK : std::uint32_t
+	{
+		kGetHandle = 0,
+		kIsConsideredSnow,
+		kGetSpecularComponent,
+		kGetAsShaderTextureSet,
+		kGetGrassList,
+		kGetHavokMaterialType,
+		kStaticClone3D,
+		kOtherClone3D,
+		kTerrainLOD,
+		kObjectLOD,
+		kTreeLOD,
+
+		kTotal
+	};
+
+	enum class LOOKUP : std::uint32_t
+	{
+		kFormSwap = 0,
+		kLandTexture,
+
+		kTotal
+	};
+
+	//calibrates the timestamp counter and dumps the stats at exit
+	void Init();
+	//writes the stats to the log, and to po3_SeasonsOfSkyrim_profile.json next to it
+	void Dump();
+
+#ifdef SOS_PROFILER
+	inline constexpr std::size_t numBuckets = 32;  //power of two buckets, in cycles
+
+	struct HookCounters
+	{
+		std::atomic<std::uint64_t> calls{ 0 };
+		std::atomic<std::uint64_t> cycles{ 0 };
+		std::atomic<std::uint64_t> maxCycles{ 0 };
+		std::array<std::atomic<std::uint64_t>, numBuckets> buckets{};
+	};
+
+	struct LookupCounters
+	{
+		std::atomic<std::uint64_t> hits{ 0 };
+		std::atomic<std::uint64_t> misses{ 0 };
+	};
+
+	struct ThreadCounters
+	{
+		std::array<HookCounters, stl::to_underlying(HOOK::kTotal)> hooks{};
+		std::array<LookupCounters, stl::to_underlying(LOOKUP::kTotal)> lookups{};
+	};
+
+	//registered on first use, and kept alive after the thread exits
+	ThreadCounters& get_thread_counters();
+
+	//each thread only writes its own counters, so a relaxed load/store is enough and avoids locked instructions
+	inline void add(std::atomic<std::uint64_t>& a_counter, std::uint64_t a_value)
+	{
+		a_counter.store(a_counter.load(std::memory_order_relaxed) + a_value, std::memory_order_relaxed);
+	}
+
+	inline void RecordHook(HOOK a_hook, std::uint64_t a_cycles)
+	{
+		auto& counters = get_thread_counters().hooks[stl::to_underlying(a_hook)];
+
+		add(counters.calls, 1);
+		add(counters.cycles, a_cycles);
+		if (a_cycles > counters.maxCycles.load(std::memory_order_relaxed)) {
+			counters.maxCycles.store(a_cycles, std::memory_order_relaxed);
+		}
+		add(counters.buckets[std::min<std::size_t>(std::bit_width(a_cycles), numBuckets - 1)], 1);
+	}
+
+	inline void RecordLookup(LOOKUP a_lookup, bool a_hit)
+	{
+		auto& counters = get_thread_counters().lookups[stl::to_underlying(a_lookup)];
+		add(a_hit ? counters.hits : counters.misses, 1);
+	}
+
+	class ScopedTimer
+	{
+	public:
+		explicit ScopedTimer(HOOK a_hook) :
+			hook(a_hook),
+			start(__rdtsc())
+		{}
+		~ScopedTimer()
+		{
+			RecordHook(hook, __rdtsc() - start);
+		}
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+		HOOK hook;
+		std::uint64_t start;
+	};
+#endif
+}
+
+#ifdef SOS_PROFILER
+#	define PROFILE_HOOK(a_hook) const Profiler::ScopedTimer profilerTimer_ { a_hook }
+#	define PROFILE_LOOKUP(a_lookup, a_hit) Profiler::RecordLookup(a_lookup, a_hit)
+#else
+#	define PROFILE_HOOK(a_hook) (void)0
+#	define PROFILE_LOOKUP(a_lookup, a_hit) (void)0
+#endif
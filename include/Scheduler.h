@@ -0,0 +1,128 @@
+#pragma once
+
+//Runs deferred work on the main thread, under a per-frame time budget
+namespace Scheduler
+{
+	enum class PRIORITY : std::uint32_t
+	{
+		kHigh = 0,
+		kNormal,
+		kLow,
+
+		kTotal
+	};
+
+	using TaskID = std::uint32_t;
+
+	//called with the remaining budget (ms), returns true when finished
+	using Task = std::function<bool(float)>;
+
+	struct TaskStats
+	{
+		std::uint64_t calls{ 0 };
+		double totalTime{ 0.0 };  //ms
+		double maxTime{ 0.0 };    //ms
+	};
+
+	struct Stats
+	{
+		std::size_t queueDepth{ 0 };
+		std::uint64_t frames{ 0 };
+		std::uint64_t overruns{ 0 };  //frames that went over budget
+		std::uint64_t cancelled{ 0 };
+		std::map<std::string, TaskStats> tasks{};
+	};
+
+	class Manager
+	{
+	public:
+		static Manager* GetSingleton()
+		{
+			static Manager singleton;
+			return std::addressof(singleton);
+		}
+
+		void LoadSettings(CSimpleIniA& a_ini);
+
+		//thread safe, tasks always run on the main thread
+		TaskID Queue(std::string a_name, PRIORITY a_priority, Task a_task);
+		void Cancel(TaskID a_id);
+		void Cancel(std::string_view a_name);
+
+		void Update();
+
+		//runs once on the main thread when the game starts quitting, while other threads are still alive (unlike atexit).
+		//callbacks run in reverse order of registration
+		void OnQuit(std::function<void()> a_callback);
+		void Quit();
+
+		[[nodiscard]] Stats GetStats() const;
+		void LogStats() const;
+
+	protected:
+		Manager() = default;
+		Manager(const Manager&) = delete;
+		Manager(Manager&&) = delete;
+		~Manager() = default;
+
+		Manager& operator=(const Manager&) = delete;
+		Manager& operator=(Manager&&) = delete;
+
+	private:
+		using Lock = std::mutex;
+		using Locker = std::scoped_lock<Lock>;
+
+		struct Entry
+		{
+			TaskID id;
+			std::string name;
+			Task task;
+		};
+
+		void CollectPending();
+
+		struct
+		{
+			float budget{ 3.0f };  //ms per frame
+		} settings;
+
+		mutable Lock _pendingLock;
+		std::vector<std::pair<PRIORITY, Entry>> _pending{};
+		std::vector<TaskID> _cancelled{};
+		std::vector<std::string> _cancelledNames{};
+		TaskID _nextID{ 1 };
+		std::vector<std::function<void()>> _quitCallbacks{};
+		bool _quit{ false };
+
+		//main thread only
+		std::array<std::deque<Entry>, stl::to_underlying(PRIORITY::kTotal)> _queues{};
+
+		mutable Lock _statsLock;
+		Stats _stats{};
+		std::chrono::steady_clock::time_point _lastStatsLog{};
+	};
+
+	struct MainUpdate
+	{
+		static void thunk()
+		{
+			func();
+
+			const auto manager = Manager::GetSingleton();
+			manager->Update();
+
+			if (const auto main = RE::Main::GetSingleton(); main && main->quitGame) {
+				manager->Quit();
+			}
+		}
+		static inline REL::Relocation<decltype(thunk)> func;
+	};
+
+	inline void Install()
+	{
+		REL::Relocation<std::uintptr_t> target{ RELOCATION_ID(35565, 36564), OFFSET(0x748, 0xC26) };  //Main::Update
+		stl::write_thunk_call<MainUpdate>(target.address());
+
+		logger::info("Installed task scheduler"sv);
+	}
+}
@@ -1,10 +1,14 @@
 #pragma once
 
 #include "Seasons.h"
+#include "SnowSwap.h"
 
 class SeasonManager final : public RE::BSTEventSink<RE::TESActivateEvent>
 {
 public:
+	//also read by SKSEPlugin_Load, before settings are loaded
+	static constexpr auto settings{ L"Data/SKSE/Plugins/po3_SeasonsOfSkyrim.ini" };
+
 	[[nodiscard]] static SeasonManager* GetSingleton()
 	{
 		static SeasonManager singleton;
@@ -24,6 +28,8 @@ public:
 			scripts->AddEventSink<RE::TESActivateEvent>(GetSingleton());
 			logger::info("Registered {}"sv, typeid(RE::TESActivateEvent).name());
 		}
+
+		GetSingleton()->RegisterSeasonChangeDispatch();
 	}
 
 	void LoadSettings();
@@ -38,40 +44,80 @@ public:
 
 	bool UpdateSeason();
 
+	//next season and game hours until it starts, when seasonal
+	[[nodiscard]] std::optional<std::pair<SEASON, float>> GetNextSeasonChange() const;
+
 	[[nodiscard]] SEASON GetCurrentSeasonType();
 	[[nodiscard]] SEASON GetSeasonType();
 	[[nodiscard]] bool CanApplySnowShader();
 
 	[[nodiscard]] std::pair<bool, std::string> CanSwapLOD(LOD_TYPE a_type);
+	[[nodiscard]] std::pair<bool, std::string> CanSwapLOD(SEASON a_season, LOD_TYPE a_type, const RE::TESWorldSpace* a_worldSpace);
 
 	[[nodiscard]] bool CanSwapLandscape();
 	[[nodiscard]] bool CanSwapForm(RE::FormType a_formType);
 	[[nodiscard]] bool CanSwapGrass();
 
+	[[nodiscard]] const SEASON_DELTA& GetSeasonDelta(SEASON a_oldSeason, SEASON a_newSeason) const;
+	[[nodiscard]] bool RequiresCellReload(SEASON a_oldSeason, SEASON a_newSeason) const;
+
+	void GetMemoryUsage(std::vector<memory::TableStats>& a_stats);
+
+	template <class F>
+	void ForEachSeason(F&& a_func)
+	{
+		for (const auto season : { &winter, &spring, &summer, &autumn }) {
+			a_func(*season);
+		}
+	}
+
 	RE::TESBoundObject* GetSwapForm(const RE::TESForm* a_form);
+	RE::TESBoundObject* GetSwapForm(SEASON a_season, const RE::TESForm* a_form);
 	template <class T>
 	T* GetSwapForm(const RE::TESForm* a_form);
 
 	RE::TESLandTexture* GetSwapLandTexture(const RE::TESLandTexture* a_landTxst);
+	RE::TESLandTexture* GetSwapLandTexture(SEASON a_season, const RE::TESLandTexture* a_landTxst);
 	RE::TESLandTexture* GetSwapLandTexture(const RE::BGSTextureSet* a_txst);
 
+	//swapped land texture values for the published state, nullptr if it isn't current or the landscape can't be swapped
+	[[nodiscard]] const LAND_TEXTURE_DATA* GetLandTextureData(const RE::TESLandTexture* a_landTexture) const;
+	[[nodiscard]] const LAND_TEXTURE_DATA* GetLandTextureData(const RE::BGSTextureSet* a_txst) const;
+
 	[[nodiscard]] bool GetExterior();
 	void SetExterior(bool a_isExterior);
 
 	SEASON GetSeasonOverride() const;
 	void SetSeasonOverride(SEASON a_season);
 
+	//main thread only. Rebuilds the season state read by the hooks, and publishes it if it changed
+	void PublishState();
+	//epoch of the published state, or 0 if it is not current
+	[[nodiscard]] std::uint32_t GetStateEpoch() const;
+	//references that can change base a cell needs before it is decided as a batch, 0 if cells are never batched
+	[[nodiscard]] std::uint32_t GetCellBatchRefs() const;
+
 protected:
 	using MONTH = RE::Calendar::Month;
 	using EventResult = RE::BSEventNotifyControl;
 
 	Season* GetSeason();
 	Season* GetCurrentSeason(bool a_ignoreOverride = false);
+
+	//published state, or nullptr if it was built for another worldspace and the caller has to work it out
+	[[nodiscard]] const SEASON_STATE* GetState() const;
 	Season* GetSeasonImpl(SEASON a_season);
 
 	void LoadMonthToSeasonMap(CSimpleIniA& a_ini);
 
+	//season changes are coalesced, and OnSeasonChange is sent once for the final state
+	void QueueSeasonChange(SEASON a_oldSeason, SEASON a_newSeason, bool a_override);
+	void DispatchSeasonChange();
+	void RegisterSeasonChangeDispatch();
+
 	static void LoadSeasonData(Season& a_season, CSimpleIniA& a_settings);
+	void BuildSeasonDeltas();
+	void BuildLandTextureTables();
 
 	bool ShouldRegenerateWinterFormSwap() const;
 
@@ -89,6 +135,9 @@ protected:
 				if (!a_isInterior) {
 					manager->UpdateSeason();
 				}
+				manager->PublishState();
+
+				SnowSwap::Manager::GetSingleton()->UpdateMultiPassSnow();
 			}
 			static inline REL::Relocation<decltype(thunk)> func;
 		};
@@ -158,10 +207,41 @@ private:
 
 	SEASON seasonOverride{ SEASON::kNone };
 
+	//[old season][new season], including kNone
+	std::array<std::array<SEASON_DELTA, 5>, 5> seasonDeltas{};
+
+	//every land texture gets a slot, texture sets map to the slot of the land texture using them
+	Map<RE::FormID, std::uint32_t> landTextureSlots{};
+	Map<RE::FormID, std::uint32_t> textureSetSlots{};
+	std::optional<std::uint32_t> defaultLandTextureSlot{};  //unmapped texture sets use the default land texture
+	std::array<std::vector<LAND_TEXTURE_DATA>, 5> landTextureTables{};  //[season][slot]
+
 	std::atomic_bool isExterior{ false };
 
+	//hooks do one acquire load. States are interned by contents and never freed, so any state a reader loaded stays valid.
+	//there is one per season, worldspace and swap flags seen this session. Main thread only
+	const SEASON_STATE emptyState{};
+	std::atomic<const SEASON_STATE*> state{ &emptyState };
+	std::vector<std::unique_ptr<const SEASON_STATE>> internedStates{};
+
 	bool loadedFromSave{ false };
 
+	struct PendingSeasonChange
+	{
+		SEASON oldSeason;
+		SEASON newSeason;
+		bool isOverride;
+		std::uint32_t count;
+		std::chrono::steady_clock::time_point lastChange;
+	};
+	std::optional<PendingSeasonChange> pendingSeasonChange{};
+
+	float seasonChangeDebounce{ 500.0f };  //ms
+	std::uint32_t cellBatchRefs{ 0 };
+
+	std::uint32_t detectedSeasonChanges{ 0 };
+	std::uint32_t mergedSeasonChanges{ 0 };
+
 	struct
 	{
 		bool skip{ false };
@@ -175,7 +255,6 @@ private:
 
 	} mainWINSwap;
 
-	const wchar_t* settings{ L"Data/SKSE/Plugins/po3_SeasonsOfSkyrim.ini" };
 	const wchar_t* serializedSeasonList{ L"Data/Seasons/Serialization.ini" };
 };
 
@@ -28,6 +28,13 @@ struct SEASON_ID
 	std::string suffix{};
 };
 
+//forms that look different after going from one season to another
+struct SEASON_DELTA
+{
+	Set<RE::FormID> bases{};         //swap target differs
+	Set<RE::FormID> landTextures{};  //texture or grass list differs
+};
+
 enum class LOD_TYPE : std::uint32_t
 {
 	kTerrain = 0,
@@ -47,9 +54,17 @@ public:
 
 	[[nodiscard]] bool CanApplySnowShader() const;
 	[[nodiscard]] bool CanSwapForm(RE::FormType a_formType) const;
+	[[nodiscard]] bool CanSwapForm(RE::FormType a_formType, const RE::TESWorldSpace* a_worldSpace) const;
+	[[nodiscard]] bool IsInValidWorldSpace(const RE::TESWorldSpace* a_worldSpace) const;
 	[[nodiscard]] bool CanSwapLOD(LOD_TYPE a_type) const;
+	[[nodiscard]] bool CanSwapLOD(LOD_TYPE a_type, const RE::TESWorldSpace* a_worldSpace) const;
 	[[nodiscard]] bool CanSwapLandscape() const;
 
+	//swaps for enabled form types, regardless of worldspace
+	[[nodiscard]] MapPair<RE::FormID> GetEffectiveSwaps();
+	[[nodiscard]] MapPair<RE::FormID> GetEffectiveLandTextureSwaps();
+	[[nodiscard]] bool GetEffectiveGrassSwap() const;
+
 	[[nodiscard]] const SEASON_ID& GetID() const;
 	[[nodiscard]] SEASON GetType() const;
 
@@ -111,9 +126,55 @@ private:
 		}
 	}
 
+	[[nodiscard]] bool is_in_valid_worldspace(const RE::TESWorldSpace* a_worldSpace) const
+	{
+		return a_worldSpace && std::ranges::find(validWorldspaces, a_worldSpace->GetFormEditorID()) != validWorldspaces.end();
+	}
+
 	[[nodiscard]] bool is_in_valid_worldspace() const
 	{
-		const auto worldSpace = RE::TES::GetSingleton()->worldSpace;
-		return worldSpace && std::ranges::find(validWorldspaces, worldSpace->GetFormEditorID()) != validWorldspaces.end();
+		return is_in_valid_worldspace(RE::TES::GetSingleton()->worldSpace);
+	}
+};
+
+//land texture values seen by create_land_geometry and grass/havok lookups, after the season's swap
+struct LAND_TEXTURE_DATA
+{
+	RE::FormID swapID{ 0 };                         //0 if not swapped
+	RE::BGSTextureSet* swapTextureSet{ nullptr };  //only set when swapped
+	RE::BSSimpleList<RE::TESGrass*>* grassList{ nullptr };
+	RE::MATERIAL_ID materialID{ RE::MATERIAL_ID::kNone };
+	float specularExponent{ 0.0f };
+	bool isSnow{ false };
+};
+
+//what the hooks need to know about the active season, rebuilt by the main thread when it changes and never modified after
+struct SEASON_STATE
+{
+	Season* season{ nullptr };  //nullptr in interiors
+	SEASON type{ SEASON::kNone };
+	const RE::TESWorldSpace* worldSpace{ nullptr };
+	std::uint32_t epoch{ 0 };  //unique per interned state, so a state returned to keeps its epoch. 0 before the first
+
+	bool canSwapLandscape{ false };
+	bool canApplySnowShader{ false };
+	std::bitset<stl::to_underlying(RE::FormType::Max)> swapFormTypes{};
+
+	std::array<bool, 3> swapLOD{};  //by LOD_TYPE
+	std::string lodSuffix{};
+
+	const LAND_TEXTURE_DATA* landTextures{ nullptr };  //by land texture slot, nullptr if the landscape can't be swapped
+
+	[[nodiscard]] bool CanSwapForm(RE::FormType a_formType) const
+	{
+		return stl::to_underlying(a_formType) < swapFormTypes.size() && swapFormTypes.test(stl::to_underlying(a_formType));
+	}
+
+	//everything but the epoch
+	[[nodiscard]] bool HasSameContents(const SEASON_STATE& a_rhs) const
+	{
+		return season == a_rhs.season && type == a_rhs.type && worldSpace == a_rhs.worldSpace &&
+		       canSwapLandscape == a_rhs.canSwapLandscape && canApplySnowShader == a_rhs.canApplySnowShader &&
+		       swapFormTypes == a_rhs.swapFormTypes && swapLOD == a_rhs.swapLOD && lodSuffix == a_rhs.lodSuffix && landTextures == a_rhs.landTextures;
 	}
 };
@@ -1,5 +1,10 @@
 #pragma once
 
+#include "Capture.h"
+#include "CellIndex.h"
+#include "Profiler.h"
+#include "Worker.h"
+
 namespace SnowSwap
 {
 	enum class SNOW_TYPE
@@ -28,7 +33,7 @@ namespace SnowSwap
 	public:
 		struct SnowInfo
 		{
-			RE::FormID origShader;
+			RE::BGSMaterialObject* origShader;
 			SNOW_TYPE snowType;
 		};
 
@@ -45,18 +50,61 @@ namespace SnowSwap
 			return std::addressof(singleton);
 		}
 
+		void LoadSettings(CSimpleIniA& a_ini);
 		void LoadSnowShaderSettings();
 
+		void LoadSnowTypeCache();
+		void SaveSnowTypeCache();
+		//a_onFinished is called from the classification worker once every model is classified
+		void PrecomputeSnowTypes(std::function<void()> a_onFinished = {});
+		//only collects model paths on the calling thread, fingerprinting and scanning run on the classification worker
+		void PrecomputeSnowTypes(const Set<RE::FormID>& a_statics);
+
 		[[nodiscard]] SWAP_RESULT CanApplySnowShader(RE::TESObjectREFR* a_ref) const;
 		[[nodiscard]] SWAP_RESULT CanApplySnowShader(RE::TESObjectSTAT* a_static, RE::TESObjectREFR* a_ref) const;
 
-		[[nodiscard]] SNOW_TYPE GetSnowType(const RE::TESObjectSTAT* a_static, RE::NiAVObject* a_node) const;
+		[[nodiscard]] bool IsValidSnowBase(const RE::TESObjectSTAT* a_static) const;
+
+		[[nodiscard]] std::optional<SNOW_TYPE> GetSnowType(const RE::TESObjectSTAT* a_static);
+		[[nodiscard]] SNOW_TYPE GetSnowType(const RE::TESObjectSTAT* a_static, RE::NiAVObject* a_node);
 
-		void ApplySinglePassSnow(RE::NiAVObject* a_node, float a_angle = 90.0f);
-		void RemoveSinglePassSnow(RE::NiAVObject* a_node) const;
+		void ApplySinglePassSnow(RE::NiAVObject* a_node, const RE::TESModel* a_model, float a_angle = 90.0f);
+		void RemoveSinglePassSnow(RE::NiAVObject* a_node, const RE::TESModel* a_model);
+
+		//update snow on already loaded 3D, returns true if the reference has to be reloaded instead
+		bool UpdateLoadedSnow(RE::TESObjectREFR* a_ref, RE::NiAVObject* a_node);
+
+		//distant single pass snow is applied after the reference loads, nearest first
+		[[nodiscard]] bool ShouldQueueSnow(const RE::TESObjectREFR* a_ref) const;
+		void QueueSnow(const RE::TESObjectREFR* a_ref);
+		void RegisterSnowQueue();
 
 		[[nodiscard]] std::optional<SnowInfo> GetSnowInfo(const RE::TESObjectSTAT* a_static);
-		void SetSnowInfo(const RE::TESObjectSTAT* a_static, RE::BGSMaterialObject* a_originalMat, SNOW_TYPE a_snowType);
+		SnowInfo SetSnowInfo(RE::TESObjectSTAT* a_static, RE::BGSMaterialObject* a_originalMat, SNOW_TYPE a_snowType);
+
+		//swap material objects of all multipass statics at once, instead of per clone. Main thread only
+		void UpdateMultiPassSnow(bool a_applySnow);
+		void UpdateMultiPassSnow();
+		[[nodiscard]] bool IsMultiPassSnowApplied() const;
+		//clones of multipass statics read the shared material object while cloning, so they hold off UpdateMultiPassSnow.
+		//a_removeSnow clones with the original material (textures included), then puts the snow material back.
+		//the material is only switched while no other multipass clone or UpdateMultiPassSnow is running
+		template <class Func>
+		RE::NiAVObject* CloneMultiPass(RE::TESObjectSTAT* a_static, RE::BGSMaterialObject* a_origShader, bool a_removeSnow, Func&& a_clone)
+		{
+			if (!a_removeSnow) {
+				ReadLocker locker(_multiPassLock);
+				return a_clone();
+			}
+
+			Locker locker(_multiPassLock);
+			const auto snowShader = std::exchange(a_static->data.materialObj, a_origShader);
+			const auto node = a_clone();
+			a_static->data.materialObj = snowShader;
+			return node;
+		}
+
+		void GetMemoryUsage(std::vector<memory::TableStats>& a_stats) const;
 
 		[[nodiscard]] RE::BGSMaterialObject* GetMultiPassSnowShader();
 		[[nodiscard]] RE::BGSMaterialObject* GetSinglePassSnowShader();
@@ -73,25 +121,85 @@ namespace SnowSwap
 	private:
 		using Lock = std::shared_mutex;
 		using Locker = std::scoped_lock<Lock>;
+		using ReadLocker = std::shared_lock<Lock>;
 		using SnowInfoMap = Map<RE::FormID, SnowInfo>;
 
+		//snow type by model, shared across statics and serialized between sessions
+		struct ModelSnowInfo
+		{
+			std::uint64_t fingerprint;
+			SNOW_TYPE snowType;
+			bool validated;
+		};
+		using ModelSnowInfoMap = Map<std::string, ModelSnowInfo>;
+
 		bool GetBlacklisted(const RE::TESForm* a_form) const;
 		bool GetBaseBlacklisted(const RE::TESForm* a_form) const;
 
 		bool GetWhitelistedForMultiPassSnow(const RE::TESForm* a_form) const;
 
+		RE::NiBooleanExtraData* GetSnowShaderData();
+
+		bool IsSnowedModel(const RE::TESModel* a_model);
+		void SetSnowedModel(const RE::TESModel* a_model);
+
+		void CacheSnowType(std::string a_path, std::uint64_t a_fingerprint, SNOW_TYPE a_snowType);
+		void ClassifySnowTypes(std::vector<std::string> a_paths, std::function<void()> a_onFinished = {});
+
+		bool ProcessSnowQueue(float a_budget);
+
+		struct QueuedSnow
+		{
+			RE::ObjectRefHandle handle;
+			std::uint32_t frames;  //frames spent waiting for 3D
+		};
+
+		struct
+		{
+			bool queueDistantSnow{ false };
+			float queueDistance{ 4096.0f };
+			std::uint32_t maxPerFrame{ 32 };
+		} settings;
+
+		mutable Lock _snowQueueLock;
+		std::vector<RE::ObjectRefHandle> _pendingSnow{};
+		std::vector<QueuedSnow> _snowQueue{};  //main thread only
+
 		Set<RE::FormID> _snowShaderBlacklist{};
 		Set<std::variant<RE::FormID, std::string>> _multipassSnowWhitelist{};
 
 		mutable Lock _snowInfoLock;
 		SnowInfoMap _snowInfoMap{};
 
+		mutable Lock _multiPassLock;
+		std::vector<std::pair<RE::TESObjectSTAT*, RE::BGSMaterialObject*>> _multiPassStatics{};
+		std::atomic_bool _multiPassSnowApplied{ false };
+
+		mutable Lock _snowTypeCacheLock;
+		ModelSnowInfoMap _snowTypeCache{};
+		bool _snowTypeCacheDirty{ false };
+
 		ProjectedUV _defaultObj{};
 
+		//one extra data shared by all snowed nodes
+		std::once_flag _snowShaderDataInit;
+		RE::NiPointer<RE::NiBooleanExtraData> _snowShaderData{};
+
+		//models that had single pass snow applied to any clone this session, keyed by interned model path
+		//clones can share shader properties, so these are the only ones that need removal passes
+		mutable Lock _snowedModelsLock;
+		Set<const char*> _snowedModels{};
+
 		RE::BGSMaterialObject* _multiPassSnowShader{ nullptr };
 		RE::BGSMaterialObject* _singlePassSnowShader{ nullptr };
 
 		Set<std::string> _snowShaderModelBlackList{ R"(Effects\)", R"(Sky\)", R"(lod\)", "WetRocks", "DynDOLOD", "Marker", "Brazier" };
+
+		static constexpr std::uint32_t snowTypeCacheVersion{ 2 };  //2 : archived models fingerprinted by header hash
+		const wchar_t* snowTypeCache{ L"Data/Seasons/SnowTypeCache.ini" };
+
+		//fingerprints, validates and scans models for the snow type cache, in request order. Last, so it is joined first
+		Worker _classifier{ "Snow type" };
 	};
 
 	namespace Statics
@@ -100,55 +208,74 @@ namespace SnowSwap
 		{
 			static RE::NiAVObject* thunk(RE::TESObjectSTAT* a_static, RE::TESObjectREFR* a_ref, bool a_arg3)
 			{
+				PROFILE_HOOK(Profiler::HOOK::kStaticClone3D);
+				Capture::record(Profiler::HOOK::kStaticClone3D, a_static->GetFormID(), a_ref ? a_ref->GetFormID() : 0);
+
+				if (!CellIndex::Manager::GetSingleton()->CanHaveSnow(a_static->GetFormID())) {
+					return func(a_static, a_ref, a_arg3);
+				}
+
 				const auto manager = Manager::GetSingleton();
 
 				auto snowInfo = manager->GetSnowInfo(a_static);
+
+				//multipass material has to be right when cloning, single pass can wait
+				if (snowInfo && snowInfo->snowType == SNOW_TYPE::kSinglePass && manager->ShouldQueueSnow(a_ref)) {
+					manager->QueueSnow(a_ref);
+					return func(a_static, a_ref, a_arg3);
+				}
+
 				const auto result = manager->CanApplySnowShader(a_static, a_ref);
 
+				//multipass materials are switched by UpdateMultiPassSnow on the main thread, and around single clones by CloneMultiPass
 				auto singlePassSnowState = SWAP_TYPE::kSkip;
+				bool removeMultiPassSnow = false;
 
 				if (result == SWAP_RESULT::kSuccess) {
+					if (!snowInfo) {
+						if (const auto snowType = manager->GetSnowType(a_static)) {
+							snowInfo = manager->SetSnowInfo(a_static, a_static->data.materialObj, *snowType);
+						}
+					}
 					if (snowInfo) {
-						auto& [origShader, snowType] = *snowInfo;
-						if (snowType == SNOW_TYPE::kMultiPass) {
-							a_static->data.materialObj = manager->GetMultiPassSnowShader();
-						} else {
+						//multipass material is set by UpdateMultiPassSnow
+						if (snowInfo->snowType == SNOW_TYPE::kSinglePass) {
 							singlePassSnowState = SWAP_TYPE::kApply;
 						}
 					} else {
 						if (auto tempNode = func(a_static, a_ref, a_arg3); tempNode) {
 							const auto snowType = manager->GetSnowType(a_static, tempNode);
-							manager->SetSnowInfo(a_static, a_static->data.materialObj, snowType);
+							snowInfo = manager->SetSnowInfo(a_static, a_static->data.materialObj, snowType);
 
 							if (snowType == SNOW_TYPE::kMultiPass) {
-								a_static->data.materialObj = manager->GetMultiPassSnowShader();
-
 								tempNode->DeleteThis();  //refCount is zero, nothing else should touch this.
 								tempNode = nullptr;
 
 							} else {
-								manager->ApplySinglePassSnow(tempNode);
+								manager->ApplySinglePassSnow(tempNode, a_static);
 								return tempNode;
 							}
 						}
 					}
 				} else if ((result == SWAP_RESULT::kSeasonFail || result == SWAP_RESULT::kRefFail) && snowInfo) {
-					auto& [origShaderID, snowType] = *snowInfo;
+					auto& [origShader, snowType] = *snowInfo;
 					if (snowType == SNOW_TYPE::kMultiPass) {
-						a_static->data.materialObj = origShaderID != 0 ?
-                                                         RE::TESForm::LookupByID<RE::BGSMaterialObject>(origShaderID) :
-                                                         nullptr;
+						//sheltered/submerged refs during winter, or a worldspace change the main thread hasn't caught up with
+						removeMultiPassSnow = manager->IsMultiPassSnowApplied();
 					} else {
 						singlePassSnowState = SWAP_TYPE::kRemove;
 					}
 				}
 
-				const auto node = func(a_static, a_ref, a_arg3);
+				const auto clone = [&]() { return func(a_static, a_ref, a_arg3); };
+				const auto node = snowInfo && snowInfo->snowType == SNOW_TYPE::kMultiPass ?
+				                      manager->CloneMultiPass(a_static, snowInfo->origShader, removeMultiPassSnow, clone) :
+				                      clone();
 
 				if (singlePassSnowState == SWAP_TYPE::kApply) {
-					manager->ApplySinglePassSnow(node, a_static->data.materialThresholdAngle);
+					manager->ApplySinglePassSnow(node, a_static, a_static->data.materialThresholdAngle);
 				} else if (singlePassSnowState == SWAP_TYPE::kRemove) {
-					manager->RemoveSinglePassSnow(node);
+					manager->RemoveSinglePassSnow(node, a_static);
 				}
 
 				return node;
@@ -171,15 +298,27 @@ namespace SnowSwap
 		{
 			static RE::NiAVObject* thunk(RE::TESBoundObject* a_base, RE::TESObjectREFR* a_ref, bool a_arg3)
 			{
+				PROFILE_HOOK(Profiler::HOOK::kOtherClone3D);
+				Capture::record(Profiler::HOOK::kOtherClone3D, a_base->GetFormID(), a_ref ? a_ref->GetFormID() : 0);
+
 				const auto node = func(a_base, a_ref, a_arg3);
 
+				if (!CellIndex::Manager::GetSingleton()->CanHaveSnow(a_base->GetFormID())) {
+					return node;
+				}
+
 				const auto manager = Manager::GetSingleton();
+				if (manager->ShouldQueueSnow(a_ref)) {
+					manager->QueueSnow(a_ref);
+					return node;
+				}
+
 				const auto result = manager->CanApplySnowShader(a_ref);
 
 				if (result == SWAP_RESULT::kSuccess) {
-					manager->ApplySinglePassSnow(node);
+					manager->ApplySinglePassSnow(node, a_base->As<RE::TESModel>());
 				} else if (result == SWAP_RESULT::kSeasonFail || result == SWAP_RESULT::kRefFail) {
-					manager->RemoveSinglePassSnow(node);
+					manager->RemoveSinglePassSnow(node, a_base->As<RE::TESModel>());
 				}
 
 				return node;
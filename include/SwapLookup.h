@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Containers.h"
+
+//FormID swap map lookups, shared by FormSwapMap and tools/capturereplay (no engine types)
+namespace SwapLookup
+{
+	using FormID = std::uint32_t;
+
+	//swap formID, or 0 if the form is unchanged
+	[[nodiscard]] inline FormID find(const MapPair<FormID>& a_map, FormID a_formID)
+	{
+		if (a_map.empty()) {
+			return 0;
+		}
+
+		const auto it = a_map.find(a_formID);
+		return it != a_map.end() ? it->second : 0;
+	}
+}
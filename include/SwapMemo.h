@@ -0,0 +1,115 @@
+#pragma once
+
+//Remembers the base each reference should end up with under the current season state.
+//Filled by the hook for references resolved one at a time, and per cell on the first reference queued from cells large enough to batch
+namespace SwapMemo
+{
+	struct Decision
+	{
+		RE::FormID base{ 0 };                  //base when the decision was made
+		RE::TESBoundObject* target{ nullptr };  //base the reference should have
+		bool recordOriginal{ false };          //base is the original, remember it before swapping
+	};
+
+	using Decisions = std::vector<std::pair<RE::FormID, Decision>>;
+
+	//one decision per run of references sharing base and original base, a_refs sorted by base and a_origBases in the same order.
+	//a_refID and a_baseOf project a reference, a_decide(base, origBase) makes a decision. Returns the number of decisions made
+	template <class Ref, class RefID, class BaseOf, class Decide>
+	std::size_t decide_grouped(const std::vector<Ref>& a_refs, const std::vector<RE::TESBoundObject*>& a_origBases, RefID&& a_refID, BaseOf&& a_baseOf, Decide&& a_decide, Decisions& a_decisions)
+	{
+		std::size_t uniqueBases = 0;
+		std::optional<std::tuple<RE::TESBoundObject*, RE::TESBoundObject*, Decision>> last;
+
+		for (std::size_t i = 0; i < a_refs.size(); ++i) {
+			const auto base = a_baseOf(a_refs[i]);
+			const auto origBase = a_origBases[i];
+
+			if (!last || std::get<0>(*last) != base || std::get<1>(*last) != origBase) {
+				last.emplace(base, origBase, a_decide(base, origBase));
+				uniqueBases++;
+			}
+
+			a_decisions.emplace_back(a_refID(a_refs[i]), std::get<2>(*last));
+		}
+
+		return uniqueBases;
+	}
+
+	class Manager
+	{
+	public:
+		static Manager* GetSingleton()
+		{
+			static Manager singleton;
+			return std::addressof(singleton);
+		}
+
+		[[nodiscard]] std::optional<Decision> Find(RE::FormID a_ref, std::uint32_t a_epoch) const;
+		void Record(RE::FormID a_ref, const Decision& a_decision, std::uint32_t a_epoch);
+		//one lock per shard for the whole batch
+		void Record(const Decisions& a_decisions, std::uint32_t a_epoch);
+
+		void CountLookup(RE::FormID a_ref, bool a_hit);
+
+		//true once per cell and epoch, for the thread that should batch it
+		[[nodiscard]] bool BeginCell(RE::FormID a_cell, std::uint32_t a_epoch);
+		void CountCell(std::size_t a_refs, std::size_t a_uniqueBases);
+
+		//main thread, when a new season state is published. Logs the hit rate of the previous epoch
+		void OnEpochChange(std::uint32_t a_epoch);
+
+		void LogStatistics() const;
+		void GetMemoryUsage(std::vector<memory::TableStats>& a_stats) const;
+
+	protected:
+		Manager() = default;
+		Manager(const Manager&) = delete;
+		Manager(Manager&&) = delete;
+		~Manager() = default;
+
+		Manager& operator=(const Manager&) = delete;
+		Manager& operator=(Manager&&) = delete;
+
+	private:
+		using Lock = std::shared_mutex;
+		using Locker = std::scoped_lock<Lock>;
+		using ReadLocker = std::shared_lock<Lock>;
+
+		struct Entry
+		{
+			std::uint32_t epoch;
+			Decision decision;
+		};
+
+		//loader threads hit different shards, and keep their own counters
+		struct alignas(64) Shard
+		{
+			mutable Lock lock;
+			Map<RE::FormID, Entry> entries{};
+
+			std::atomic<std::uint64_t> hits{ 0 };
+			std::atomic<std::uint64_t> misses{ 0 };
+		};
+
+		static constexpr std::size_t numShards{ 16 };
+
+		static std::size_t GetShardIndex(RE::FormID a_ref)
+		{
+			return (a_ref * 0x9E3779B1u) >> 28;
+		}
+
+		std::array<Shard, numShards> _shards{};
+
+		mutable Lock _cellLock;
+		Map<RE::FormID, std::uint32_t> _cells{};  //cell -> epoch it was batched in
+
+		std::atomic<std::uint64_t> _batchedCells{ 0 };
+		std::atomic<std::uint64_t> _batchedRefs{ 0 };
+		std::atomic<std::uint64_t> _batchedBases{ 0 };
+
+		std::uint32_t _epoch{ 0 };
+		std::uint64_t _totalHits{ 0 };
+		std::uint64_t _totalMisses{ 0 };
+	};
+}
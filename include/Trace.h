@@ -0,0 +1,28 @@
+#pragma once
+
+//Scoped timing zones for startup, written out in Chrome trace format (chrome://tracing, ui.perfetto.dev)
+namespace Trace
+{
+	class Zone
+	{
+	public:
+		explicit Zone(std::string a_name, std::string_view a_category = "startup"sv, std::string a_args = {});
+		~Zone();
+
+		Zone(const Zone&) = delete;
+		Zone& operator=(const Zone&) = delete;
+
+	private:
+		std::string name;
+		std::string_view category;
+		std::string args;  //shown as "detail" in the trace viewer
+		std::chrono::steady_clock::time_point start;
+		bool active;
+	};
+
+	//zones are only recorded after this ("Startup Trace" in the ini)
+	void Enable();
+
+	//writes po3_SeasonsOfSkyrim_trace.json to the log directory, zones after this are not recorded. Does nothing unless enabled
+	void Write();
+}
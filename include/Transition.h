@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Seasons.h"
+
+//Refreshes references that are already loaded after a season change, instead of purging every buffered cell
+namespace Transition
+{
+	class Manager
+	{
+	public:
+		static Manager* GetSingleton()
+		{
+			static Manager singleton;
+			return std::addressof(singleton);
+		}
+
+		void LoadSettings(CSimpleIniA& a_ini);
+
+		//called from the door activation sink, while the player is still in the interior
+		void OnSeasonChange(const RE::TESObjectREFR* a_door);
+		[[nodiscard]] bool HasDeferredChange() const;
+
+		//runs every frame through the scheduler
+		void Register();
+
+	protected:
+		Manager() = default;
+		Manager(const Manager&) = delete;
+		Manager(Manager&&) = delete;
+		~Manager() = default;
+
+		Manager& operator=(const Manager&) = delete;
+		Manager& operator=(Manager&&) = delete;
+
+	private:
+		void Update(float a_budget);
+
+		void Start();
+		bool Process(float a_budget);
+
+		//worldspace and position the door leads to
+		static std::pair<RE::TESWorldSpace*, RE::NiPoint3> GetDestination(const RE::TESObjectREFR* a_door);
+
+		struct
+		{
+			bool enabled{ true };
+			float budget{ 2.0f };  //ms per frame, within the scheduler budget
+		} settings;
+
+		//state of the exterior the buffered cells were loaded in
+		RE::TESWorldSpace* lastWorldSpace{ nullptr };
+		SEASON lastSeason{ SEASON::kNone };
+		bool lastSnowState{ false };
+
+		bool pending{ false };
+		bool deferred{ false };  //changed while going between interiors
+		std::uint32_t mergedChanges{ 0 };
+		bool snowChanged{ false };
+
+		std::vector<RE::ObjectRefHandle> queue{};
+		std::size_t queueIdx{ 0 };
+
+		std::uint32_t refreshed{ 0 };
+		std::uint32_t reloaded{ 0 };
+		std::chrono::steady_clock::time_point startTime{};
+	};
+}
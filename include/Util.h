@@ -92,6 +92,97 @@ namespace model
 		}
 		return a_path;
 	}
+
+	//lowercase, relative to meshes folder
+	inline std::string normalize_model_path(std::string a_path)
+	{
+		std::ranges::transform(a_path, a_path.begin(), [](const char a_char) {
+			return a_char == '/' ? '\\' : static_cast<char>(std::tolower(static_cast<unsigned char>(a_char)));
+		});
+		if (a_path.starts_with(R"(meshes\)")) {
+			a_path.erase(0, 7);
+		}
+		return a_path;
+	}
+
+	//bytes hashed at the start of archived files, enough for the header and the block type/size tables of most meshes
+	inline constexpr std::size_t fingerprintHeaderSize{ 4096 };
+
+	//FNV-1a
+	inline std::uint64_t hash_bytes(std::span<const std::byte> a_bytes, std::uint64_t a_hash = 14695981039346656037ull)
+	{
+		for (const auto byte : a_bytes) {
+			a_hash = (a_hash ^ static_cast<std::uint64_t>(byte)) * 1099511628211ull;
+		}
+		return a_hash;
+	}
+
+	//loose files : size + last write time
+	//archived files : size + hash of the header blocks, archives don't expose a per file write time
+	inline std::uint64_t get_fingerprint(const std::string& a_normalizedPath)
+	{
+		std::error_code ec;
+		const std::filesystem::path loosePath{ fmt::format(R"(Data\Meshes\{})", a_normalizedPath) };
+		if (const auto size = std::filesystem::file_size(loosePath, ec); !ec) {
+			const auto writeTime = std::filesystem::last_write_time(loosePath, ec);
+			return ec ? size : size ^ (static_cast<std::uint64_t>(writeTime.time_since_epoch().count()) << 1);
+		}
+
+		RE::BSResourceNiBinaryStream stream{ fmt::format(R"(Meshes\{})", a_normalizedPath) };
+		if (!stream.good()) {
+			return 0;
+		}
+
+		const std::uint64_t size = stream.stream->totalSize;
+
+		std::array<std::byte, fingerprintHeaderSize> header;
+		const auto headerSize = std::min<std::size_t>(size, header.size());
+		stream.read(header.data(), static_cast<std::uint32_t>(headerSize));
+
+		return hash_bytes({ header.data(), headerSize }, hash_bytes(std::as_bytes(std::span{ &size, 1 })));
+	}
+
+	//reads models packed in archives, loose files should be memory mapped instead
+	inline std::vector<std::byte> read_archived_model(const std::string& a_normalizedPath)
+	{
+		RE::BSResourceNiBinaryStream stream{ fmt::format(R"(Meshes\{})", a_normalizedPath) };
+		if (!stream.good()) {
+			return {};
+		}
+
+		std::vector<std::byte> buffer(stream.stream->totalSize);
+		stream.read(buffer.data(), static_cast<std::uint32_t>(buffer.size()));
+
+		return buffer;
+	}
+}
+
+namespace resource
+{
+	//reads a file through the resource system, so the real load later on is served from cache
+	//path is relative to the Data folder, returns bytes read
+	inline std::size_t prefetch_file(std::string_view a_path)
+	{
+		if (a_path.size() > 5 && string::iequals(a_path.substr(0, 5), R"(Data\)"sv)) {
+			a_path.remove_prefix(5);
+		}
+
+		RE::BSResourceNiBinaryStream stream{ std::string(a_path) };
+		if (!stream.good()) {
+			return 0;
+		}
+
+		const std::size_t size = stream.stream->totalSize;
+
+		std::vector<std::byte> buffer(std::min<std::size_t>(size, 0x10000));
+		for (std::size_t remaining = size; remaining > 0;) {
+			const auto chunk = std::min(remaining, buffer.size());
+			stream.read(buffer.data(), static_cast<std::uint32_t>(chunk));
+			remaining -= chunk;
+		}
+
+		return size;
+	}
 }
 
 namespace raycast
@@ -135,6 +226,9 @@ namespace INI
 		if constexpr (std::is_same_v<T, bool>) {
 			a_value = a_ini.GetBoolValue(a_section, a_key, a_value);
 			a_ini.SetBoolValue(a_section, a_key, a_value, a_comment);
+		} else if constexpr (std::is_arithmetic_v<T>) {
+			a_value = static_cast<T>(a_ini.GetDoubleValue(a_section, a_key, a_value));
+			a_ini.SetDoubleValue(a_section, a_key, a_value, a_comment);
 		} else if constexpr (std::is_enum_v<T>) {
 			a_value = string::lexical_cast<T>(a_ini.GetValue(a_section, a_key, std::to_string(stl::to_underlying(a_value)).c_str()));
 			a_ini.SetValue(a_section, a_key, std::to_string(stl::to_underlying(a_value)).c_str(), a_comment);
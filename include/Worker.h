@@ -0,0 +1,36 @@
+#pragma once
+
+//Runs background jobs one at a time, in queue order, on a single thread that is started on first use and reused after
+class Worker
+{
+public:
+	using Job = std::function<void()>;
+
+	explicit Worker(std::string a_name) :
+		_name(std::move(a_name))
+	{}
+	Worker(const Worker&) = delete;
+	Worker(Worker&&) = delete;
+	~Worker();
+
+	Worker& operator=(const Worker&) = delete;
+	Worker& operator=(Worker&&) = delete;
+
+	//thread safe
+	void Queue(Job a_job);
+
+	[[nodiscard]] std::size_t GetPending() const;
+
+private:
+	using Lock = std::mutex;
+	using Locker = std::unique_lock<Lock>;
+
+	void Run(std::stop_token a_stop);
+
+	std::string _name;
+
+	mutable Lock _lock;
+	std::condition_variable_any _wake;
+	std::deque<Job> _jobs{};
+	std::jthread _thread{};
+};
@@ -47,16 +47,33 @@ namespace Cache
 
 	RE::TESBoundObject* DataHolder::GetOriginalBase(RE::TESObjectREFR* a_ref)
 	{
-		Locker locker(_originalsLock);
+		const auto originalID = _originals.find(a_ref->GetFormID());
+		return originalID != 0 ? RE::TESForm::LookupByID<RE::TESBoundObject>(originalID) : a_ref->GetBaseObject();
+	}
+
+	std::vector<RE::TESBoundObject*> DataHolder::GetOriginalBases(const std::vector<RE::TESObjectREFR*>& a_refs)
+	{
+		const auto originalIDs = _originals.find(a_refs, [](const RE::TESObjectREFR* a_ref) { return a_ref->GetFormID(); });
+
+		std::vector<RE::TESBoundObject*> result;
+		result.reserve(a_refs.size());
+
+		for (std::size_t i = 0; i < a_refs.size(); ++i) {
+			result.push_back(originalIDs[i] != 0 ? RE::TESForm::LookupByID<RE::TESBoundObject>(originalIDs[i]) : a_refs[i]->GetBaseObject());
+		}
 
-		const auto it = _originals.find(a_ref->GetFormID());
-		return it != _originals.end() ? RE::TESForm::LookupByID<RE::TESBoundObject>(it->second) : a_ref->GetBaseObject();
+		return result;
 	}
 
 	void DataHolder::SetOriginalBase(const RE::TESObjectREFR* a_ref, const RE::TESBoundObject* a_originalBase)
 	{
-		Locker locker(_originalsLock);
-
 		_originals.emplace(a_ref->GetFormID(), a_originalBase->GetFormID());
 	}
+
+	void DataHolder::GetMemoryUsage(std::vector<memory::TableStats>& a_stats) const
+	{
+		a_stats.push_back(memory::get_table_stats("texture set -> land texture", _textureToLandMap));
+		a_stats.push_back(memory::get_table_stats("snow shaders", _snowShaders));
+		a_stats.push_back(_originals.get_stats("original bases"));
+	}
 }
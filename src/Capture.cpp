@@ -0,0 +1,137 @@
+#include "Capture.h"
+
+namespace Capture
+{
+	void Manager::LoadSettings(CSimpleIniA& a_ini)
+	{
+		INI::get_value(a_ini, settings.captureOnStartup, "Performance", "Capture Hook Calls", ";Record every hook call to po3_SeasonsOfSkyrim_hooks.bin in the log folder (32 bytes per call). For diagnosing performance, leave disabled otherwise.");
+		INI::get_value(a_ini, settings.maxRecords, "Performance", "Capture Max Records", ";Capture stops after this many calls.");
+
+		if (settings.captureOnStartup) {
+			Start();
+		}
+	}
+
+	void Manager::Start()
+	{
+		if (IsCapturing()) {
+			return;
+		}
+
+		auto path = logger::log_directory();
+		if (!path) {
+			return;
+		}
+		*path /= fmt::format("{}_hooks.bin", Version::PROJECT);
+
+		{
+			Locker locker(_fileLock);
+
+			_file = std::ofstream(*path, std::ios::binary | std::ios::trunc);
+			if (!_file) {
+				logger::warn("Hook capture : couldn't open {}", path->string());
+				return;
+			}
+
+			const Header header{ .recordSize = sizeof(Capture::Record), .hookCount = stl::to_underlying(Profiler::HOOK::kTotal) };
+			_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			_written = 0;
+		}
+
+		{
+			Locker locker(_buffersLock);
+			for (const auto& buffer : _buffers) {
+				Locker bufferLocker(buffer->lock);
+				buffer->records.clear();
+			}
+		}
+
+		start.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+		capturing.store(true, std::memory_order_release);
+
+		logger::info("Hook capture : started, writing to {}", path->string());
+	}
+
+	void Manager::Stop()
+	{
+		if (!capturing.exchange(false)) {
+			return;
+		}
+
+		//threads that were mid-record finish under their own buffer lock
+		{
+			Locker locker(_buffersLock);
+			for (const auto& buffer : _buffers) {
+				Locker bufferLocker(buffer->lock);
+				Write(buffer->records);
+			}
+		}
+
+		Locker locker(_fileLock);
+		_file.close();
+
+		logger::info("Hook capture : stopped, {} calls recorded", _written);
+	}
+
+	Manager::ThreadBuffer& Manager::GetThreadBuffer()
+	{
+		thread_local ThreadBuffer* buffer = [this] {
+			Locker locker(_buffersLock);
+			auto& newBuffer = _buffers.emplace_back(std::make_unique<ThreadBuffer>());
+			newBuffer->records.reserve(bufferSize);
+			return newBuffer.get();
+		}();
+		return *buffer;
+	}
+
+	void Manager::AddRecord(Profiler::HOOK a_hook, RE::FormID a_input, RE::FormID a_output, std::uint16_t a_flags, std::int16_t a_x, std::int16_t a_y, std::uint32_t a_scale)
+	{
+		auto& buffer = GetThreadBuffer();
+
+		Locker locker(buffer.lock);
+		//pairs with the release store in Start, so start is the current capture's
+		if (!capturing.load(std::memory_order_acquire)) {
+			return;
+		}
+
+		const std::chrono::steady_clock::time_point startTime{ std::chrono::steady_clock::duration{ start.load(std::memory_order_relaxed) } };
+		const auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+
+		buffer.records.push_back({ static_cast<std::uint64_t>(timestamp),
+			static_cast<std::uint32_t>(GetCurrentThreadId()),
+			static_cast<std::uint16_t>(stl::to_underlying(a_hook)),
+			a_flags,
+			a_input,
+			a_output,
+			a_x,
+			a_y,
+			a_scale });
+
+		if (buffer.records.size() >= bufferSize) {
+			Write(buffer.records);
+		}
+	}
+
+	void Manager::Write(std::vector<Capture::Record>& a_records)
+	{
+		bool full = false;
+		{
+			Locker locker(_fileLock);
+			if (_file && !a_records.empty()) {
+				const auto count = std::min<std::uint64_t>(a_records.size(), settings.maxRecords - std::min<std::uint64_t>(_written, settings.maxRecords));
+				_file.write(reinterpret_cast<const char*>(a_records.data()), static_cast<std::streamsize>(count * sizeof(Capture::Record)));
+				_written += count;
+				full = _written >= settings.maxRecords;
+			}
+		}
+		a_records.clear();
+
+		if (full && capturing.exchange(false)) {
+			logger::info("Hook capture : reached {} calls, stopping", settings.maxRecords);
+
+			//remaining thread buffers are dropped, the file is closed here
+			Locker locker(_fileLock);
+			_file.close();
+		}
+	}
+}
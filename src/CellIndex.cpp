@@ -0,0 +1,252 @@
+#include "CellIndex.h"
+#include "SeasonManager.h"
+#include "SnowSwap.h"
+
+namespace CellIndex
+{
+	void Manager::BuildSwappableBases()
+	{
+		_built = false;
+
+		_swappableBases.clear();
+		_swapBasesAndTargets.clear();
+		_snowBases.clear();
+
+		SeasonManager::GetSingleton()->ForEachSeason([&](Season& a_season) {
+			a_season.GetFormSwapMap().for_each_swap([&](RE::FormID a_base, RE::FormID a_swap) {
+				_swappableBases.insert(a_base);
+				_swapBasesAndTargets.insert(a_base);
+				_swapBasesAndTargets.insert(a_swap);  //swapped references revert from their target
+			});
+		});
+
+		const auto snowManager = SnowSwap::Manager::GetSingleton();
+		const auto dataHandler = RE::TESDataHandler::GetSingleton();
+
+		for (const auto& stat : dataHandler->GetFormArray<RE::TESObjectSTAT>()) {
+			if (stat && snowManager->IsValidSnowBase(stat)) {
+				_snowBases.insert(stat->GetFormID());
+			}
+		}
+		for (const auto& formType : { RE::FormType::MovableStatic, RE::FormType::Container }) {
+			for (const auto& form : dataHandler->GetFormArray(formType)) {
+				if (form && !form->IsMarker() && !form->IsHeadingMarker()) {
+					_snowBases.insert(form->GetFormID());
+				}
+			}
+		}
+
+		_built = true;
+
+		logger::info("Cell index : {} swappable bases ({} with targets), {} snow eligible bases", _swappableBases.size(), _swapBasesAndTargets.size(), _snowBases.size());
+	}
+
+	void Manager::Register()
+	{
+		if (const auto scripts = RE::ScriptEventSourceHolder::GetSingleton()) {
+			scripts->AddEventSink<RE::TESCellFullyLoadedEvent>(this);
+			logger::info("Registered {}"sv, typeid(RE::TESCellFullyLoadedEvent).name());
+		}
+	}
+
+	bool Manager::IsSwappableBase(RE::FormID a_base) const
+	{
+		return _swappableBases.contains(a_base);
+	}
+
+	bool Manager::IsSnowBase(RE::FormID a_base) const
+	{
+		return _snowBases.contains(a_base);
+	}
+
+	bool Manager::CanChangeBase(RE::FormID a_base) const
+	{
+		return !_built.load(std::memory_order_acquire) || _swapBasesAndTargets.contains(a_base);
+	}
+
+	bool Manager::CanHaveSnow(RE::FormID a_base) const
+	{
+		return !_built.load(std::memory_order_acquire) || _snowBases.contains(a_base);
+	}
+
+	bool Manager::IsAffected(const CellInfo& a_info, const SEASON_DELTA& a_delta, bool a_snowChanged)
+	{
+		if (a_snowChanged && a_info.snowRefs > 0) {
+			return true;
+		}
+
+		const auto& [smaller, larger] = a_info.swappableBases.size() < a_delta.bases.size() ?
+		                                    std::tie(a_info.swappableBases, a_delta.bases) :
+		                                    std::tie(a_delta.bases, a_info.swappableBases);
+		return std::ranges::any_of(smaller, [&](const auto& a_base) { return larger.contains(a_base); });
+	}
+
+	bool Manager::IsAffected(const RE::TESObjectCELL* a_cell, const SEASON_DELTA& a_delta, bool a_snowChanged) const
+	{
+		ReadLocker locker(_lock);
+
+		const auto it = _cells.find(a_cell->GetFormID());
+		return it == _cells.end() || IsAffected(it->second, a_delta, a_snowChanged);
+	}
+
+	bool Manager::HasAffectedBufferedCells(const SEASON_DELTA& a_delta, bool a_snowChanged, const Set<RE::FormID>& a_skip) const
+	{
+		ReadLocker locker(_lock);
+
+		return std::ranges::any_of(_bufferedCells, [&](const auto& a_cell) {
+			if (a_skip.contains(a_cell)) {
+				return false;
+			}
+			const auto it = _cells.find(a_cell);
+			return it == _cells.end() || IsAffected(it->second, a_delta, a_snowChanged);
+		});
+	}
+
+	void Manager::ClearBufferedCells(const Set<RE::FormID>& a_keep)
+	{
+		Locker locker(_lock);
+		if (a_keep.empty()) {
+			_bufferedCells.clear();
+		} else {
+			std::erase_if(_bufferedCells, [&](const auto& a_cell) { return !a_keep.contains(a_cell); });
+		}
+	}
+
+	Set<RE::FormID> Manager::GetBufferedBases() const
+	{
+		Set<RE::FormID> bases;
+
+		ReadLocker locker(_lock);
+		for (const auto& cellID : _bufferedCells) {
+			if (const auto it = _cells.find(cellID); it != _cells.end()) {
+				bases.insert(it->second.swappableBases.begin(), it->second.swappableBases.end());
+			}
+		}
+
+		return bases;
+	}
+
+	std::optional<CellInfo> Manager::GetCellInfo(RE::FormID a_cell) const
+	{
+		ReadLocker locker(_lock);
+
+		if (const auto it = _cells.find(a_cell); it != _cells.end()) {
+			return it->second;
+		}
+		return std::nullopt;
+	}
+
+	std::vector<CellInfo> Manager::GetCellsInGrid(RE::FormID a_worldSpace, std::int32_t a_x, std::int32_t a_y, std::int32_t a_radius) const
+	{
+		std::vector<CellInfo> cells;
+
+		ReadLocker locker(_lock);
+		for (const auto& [cellID, info] : _cells) {
+			if (info.worldSpace == a_worldSpace && std::abs(info.x - a_x) <= a_radius && std::abs(info.y - a_y) <= a_radius) {
+				cells.push_back(info);
+			}
+		}
+
+		return cells;
+	}
+
+	Map<RE::FormID, WorldSpaceStats> Manager::GetWorldSpaceStats() const
+	{
+		Map<RE::FormID, WorldSpaceStats> stats;
+
+		ReadLocker locker(_lock);
+		for (const auto& [cellID, info] : _cells) {
+			auto& wsStats = stats[info.worldSpace];
+			wsStats.cells++;
+			wsStats.refs += info.refs;
+			wsStats.swappableRefs += info.swappableRefs;
+			wsStats.snowRefs += info.snowRefs;
+			if (info.swappableRefs > 0 || info.snowRefs > 0) {
+				wsStats.affectedCells++;
+			}
+		}
+
+		return stats;
+	}
+
+	void Manager::GetMemoryUsage(std::vector<memory::TableStats>& a_stats) const
+	{
+		a_stats.push_back(_swappableBases.get_stats("swappable bases"));
+		a_stats.push_back(_swapBasesAndTargets.get_stats("swap prefilter"));
+		a_stats.push_back(_snowBases.get_stats("snow bases"));
+
+		ReadLocker locker(_lock);
+		a_stats.push_back(memory::get_table_stats("indexed cells", _cells));
+		a_stats.push_back(memory::get_table_stats("buffered cells", _bufferedCells));
+
+		memory::TableStats cellBases{ "indexed cell bases" };
+		for (const auto& info : _cells | std::views::values) {
+			memory::accumulate(cellBases, memory::get_table_stats({}, info.swappableBases));
+			memory::accumulate(cellBases, memory::get_table_stats({}, info.snowBases));
+		}
+		a_stats.push_back(std::move(cellBases));
+	}
+
+	void Manager::LogStatistics() const
+	{
+		for (const auto& [worldSpaceID, stats] : GetWorldSpaceStats()) {
+			const auto worldSpace = RE::TESForm::LookupByID(worldSpaceID);
+			logger::info("	{} : {}/{} cells affected, {} refs ({} swappable, {} snow eligible)",
+				worldSpace ? util::get_editorID(worldSpace) : fmt::format("0x{:X}", worldSpaceID),
+				stats.affectedCells, stats.cells, stats.refs, stats.swappableRefs, stats.snowRefs);
+		}
+	}
+
+	Manager::EventResult Manager::ProcessEvent(const RE::TESCellFullyLoadedEvent* a_event, RE::BSTEventSource<RE::TESCellFullyLoadedEvent>*)
+	{
+		const auto cell = a_event ? a_event->cell : nullptr;
+		if (!cell || !cell->IsExteriorCell()) {
+			return EventResult::kContinue;
+		}
+
+		const auto cellID = cell->GetFormID();
+
+		{
+			Locker locker(_lock);
+			_bufferedCells.emplace(cellID);
+			if (_cells.contains(cellID)) {
+				return EventResult::kContinue;
+			}
+		}
+
+		CellInfo info{};
+		if (const auto worldSpace = cell->worldSpace) {
+			info.worldSpace = worldSpace->GetFormID();
+		}
+		if (const auto coordinates = cell->GetCoordinates()) {
+			info.x = coordinates->cellX;
+			info.y = coordinates->cellY;
+		}
+
+		cell->ForEachReference([&](RE::TESObjectREFR& a_ref) {
+			const auto base = util::get_original_base(&a_ref);
+			if (!base) {
+				return RE::BSContainer::ForEachResult::kContinue;
+			}
+
+			info.refs++;
+
+			const auto baseID = base->GetFormID();
+			if (_swappableBases.contains(baseID)) {
+				info.swappableRefs++;
+				info.swappableBases.emplace(baseID);
+			}
+			if (_snowBases.contains(baseID)) {
+				info.snowRefs++;
+				info.snowBases.emplace(baseID);
+			}
+
+			return RE::BSContainer::ForEachResult::kContinue;
+		});
+
+		Locker locker(_lock);
+		_cells.insert_or_assign(cellID, std::move(info));
+
+		return EventResult::kContinue;
+	}
+}
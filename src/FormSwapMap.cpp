@@ -1,4 +1,6 @@
 #include "FormSwapMap.h"
+#include "SwapLookup.h"
+#include "Trace.h"
 
 FormSwapMap::FormSwapMap()
 {
@@ -51,9 +53,28 @@ RE::TESLandTexture* FormSwapMap::GenerateLandTextureSnowVariant(const RE::TESLan
 
 void FormSwapMap::LoadFormSwaps(const std::string& a_type, const std::vector<std::string>& a_values)
 {
+	//a missing plugin can fail thousands of entries, only the first few are logged in full
+	constexpr std::size_t maxLoggedErrors = 10;
+
+	std::size_t errors = 0;
+	std::size_t missingBase = 0;
+	std::size_t missingSwap = 0;
+	std::size_t malformed = 0;
+
+	const auto log_error = [&](const std::string& a_key, RE::FormID a_formID, RE::FormID a_swapFormID, std::string_view a_reason) {
+		if (errors++ < maxLoggedErrors) {
+			logger::error("		failed to process {} [{:X}|{:X}] ({})", a_key, a_formID, a_swapFormID, a_reason);
+		}
+	};
+
 	auto& map = get_map(a_type);
 	for (const auto& key : a_values) {
 		const auto formPair = string::split(key, "|");
+		if (formPair.size() < 2) {
+			++malformed;
+			log_error(key, 0, 0, "expected BASE|SWAP"sv);
+			continue;
+		}
 
 		const auto formID = INI::parse_form(formPair[kBase]);
 		const auto swapFormID = INI::parse_form(formPair[kSwap]);
@@ -62,12 +83,18 @@ void FormSwapMap::LoadFormSwaps(const std::string& a_type, const std::vector<std
 			if (swapFormID != 0) {
 				map.insert_or_assign(formID, swapFormID);
 			} else {
-				logger::error("		failed to process {} [{:X}|{:X}] (SWAP formID not found)", key, formID, swapFormID);
+				++missingSwap;
+				log_error(key, formID, swapFormID, "SWAP formID not found"sv);
 			}
 		} else {
-			logger::error("		failed to process {} [{:X}|{:X}] (BASE formID not found)", key, formID, swapFormID);
+			++missingBase;
+			log_error(key, formID, swapFormID, "BASE formID not found"sv);
 		}
 	}
+
+	if (errors > maxLoggedErrors) {
+		logger::error("		...{} more failed entries ({} BASE not found, {} SWAP not found, {} malformed in total)", errors - maxLoggedErrors, missingBase, missingSwap, malformed);
+	}
 }
 
 void FormSwapMap::LoadFormSwaps(const CSimpleIniA& a_ini)
@@ -105,6 +132,8 @@ bool FormSwapMap::GenerateFormSwaps(CSimpleIniA& a_ini, bool a_forceRegenerate)
 				a_ini.Delete(type.c_str(), nullptr, true);
 			}
 
+			const Trace::Zone zone{ "GenerateFormSwaps", "startup"sv, type };
+
 			switch (string::const_hash(type)) {
 			case string::const_hash("LandTextures"sv):
 				{
@@ -153,24 +182,14 @@ bool FormSwapMap::GenerateFormSwaps(CSimpleIniA& a_ini, bool a_forceRegenerate)
 
 RE::TESBoundObject* FormSwapMap::GetSwapForm(const RE::TESForm* a_form)
 {
-	auto& map = get_map(a_form->GetFormType());
-	if (map.empty()) {
-		return nullptr;
-	}
-
-	const auto it = map.find(a_form->GetFormID());
-	return it != map.end() ? RE::TESForm::LookupByID<RE::TESBoundObject>(it->second) : nullptr;
+	const auto swapID = SwapLookup::find(get_map(a_form->GetFormType()), a_form->GetFormID());
+	return swapID != 0 ? RE::TESForm::LookupByID<RE::TESBoundObject>(swapID) : nullptr;
 }
 
 RE::TESLandTexture* FormSwapMap::GetSwapLandTexture(const RE::TESLandTexture* a_landTxst)
 {
-	const auto& map = _formMap["LandTextures"];
-	if (map.empty()) {
-		return nullptr;
-	}
-
-	const auto it = map.find(a_landTxst->GetFormID());
-	return it != map.end() ? RE::TESForm::LookupByID<RE::TESLandTexture>(it->second) : nullptr;
+	const auto swapID = SwapLookup::find(_formMap["LandTextures"], a_landTxst->GetFormID());
+	return swapID != 0 ? RE::TESForm::LookupByID<RE::TESLandTexture>(swapID) : nullptr;
 }
 
 RE::TESLandTexture* FormSwapMap::GetSwapLandTexture(const RE::BGSTextureSet* a_txst)
@@ -178,3 +197,11 @@ RE::TESLandTexture* FormSwapMap::GetSwapLandTexture(const RE::BGSTextureSet* a_t
 	const auto landTexture = Cache::DataHolder::GetSingleton()->GetLandTextureFromTextureSet(a_txst);
 	return GetSwapLandTexture(landTexture);
 }
+
+void FormSwapMap::GetMemoryUsage(const std::string& a_season, std::vector<memory::TableStats>& a_stats) const
+{
+	a_stats.push_back(memory::get_table_stats(fmt::format("{} sections", a_season), _formMap));
+	for (const auto& [type, formMap] : _formMap) {
+		a_stats.push_back(memory::get_table_stats(fmt::format("{} [{}]", a_season, type), formMap));
+	}
+}
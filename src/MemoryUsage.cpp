@@ -0,0 +1,41 @@
+#include "MemoryUsage.h"
+#include "CellIndex.h"
+#include "Prefetch.h"
+#include "SeasonManager.h"
+#include "SnowSwap.h"
+#include "SwapMemo.h"
+
+namespace memory
+{
+	std::vector<TableStats> get_plugin_stats()
+	{
+		std::vector<TableStats> stats;
+
+		SeasonManager::GetSingleton()->GetMemoryUsage(stats);
+		Cache::DataHolder::GetSingleton()->GetMemoryUsage(stats);
+		SnowSwap::Manager::GetSingleton()->GetMemoryUsage(stats);
+		CellIndex::Manager::GetSingleton()->GetMemoryUsage(stats);
+		Prefetch::Manager::GetSingleton()->GetMemoryUsage(stats);
+		SwapMemo::Manager::GetSingleton()->GetMemoryUsage(stats);
+
+		return stats;
+	}
+
+	void log_plugin_stats()
+	{
+		const auto stats = get_plugin_stats();
+
+		logger::info("{:*^30}", "MEMORY");
+
+		std::size_t totalBytes = 0;
+		for (const auto& [name, entries, buckets, bytes, loadFactor] : stats) {
+			if (entries == 0 && bytes == 0) {
+				continue;
+			}
+			logger::info("	{} : {} entries, {} buckets ({:.2f} load), {:.1f} KB", name, entries, buckets, loadFactor, static_cast<double>(bytes) / 1024.0);
+			totalBytes += bytes;
+		}
+
+		logger::info("Total : {:.1f} KB", static_cast<double>(totalBytes) / 1024.0);
+	}
+}
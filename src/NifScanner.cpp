@@ -0,0 +1,492 @@
+#include "NifScanner.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#	include <Windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+using namespace std::literals;
+
+namespace NifScanner
+{
+	MappedFile::MappedFile(const std::filesystem::path& a_path)
+	{
+#ifdef _WIN32
+		const auto file = CreateFileW(a_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			return;
+		}
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+			CloseHandle(file);
+			return;
+		}
+		const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) {
+			CloseHandle(file);
+			return;
+		}
+		const auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!view) {
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return;
+		}
+		_file = file;
+		_mapping = mapping;
+		_data = static_cast<const std::byte*>(view);
+		_size = static_cast<std::size_t>(size.QuadPart);
+#else
+		const auto file = ::open(a_path.c_str(), O_RDONLY);
+		if (file < 0) {
+			return;
+		}
+		struct stat info{};
+		if (::fstat(file, &info) != 0 || info.st_size == 0) {
+			::close(file);
+			return;
+		}
+		const auto view = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		::close(file);
+		if (view == MAP_FAILED) {
+			return;
+		}
+		_data = static_cast<const std::byte*>(view);
+		_size = static_cast<std::size_t>(info.st_size);
+#endif
+	}
+
+	MappedFile::MappedFile(MappedFile&& a_rhs) noexcept
+	{
+		*this = std::move(a_rhs);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& a_rhs) noexcept
+	{
+		if (this != &a_rhs) {
+			close();
+			_data = std::exchange(a_rhs._data, nullptr);
+			_size = std::exchange(a_rhs._size, 0);
+#ifdef _WIN32
+			_file = std::exchange(a_rhs._file, nullptr);
+			_mapping = std::exchange(a_rhs._mapping, nullptr);
+#endif
+		}
+		return *this;
+	}
+
+	void MappedFile::close()
+	{
+#ifdef _WIN32
+		if (_data) {
+			UnmapViewOfFile(_data);
+		}
+		if (_mapping) {
+			CloseHandle(_mapping);
+		}
+		if (_file) {
+			CloseHandle(_file);
+		}
+		_file = nullptr;
+		_mapping = nullptr;
+#else
+		if (_data) {
+			::munmap(const_cast<std::byte*>(_data), _size);
+		}
+#endif
+		_data = nullptr;
+		_size = 0;
+	}
+
+	namespace detail
+	{
+		//bounds checked little endian cursor, sets fail on overrun instead of throwing
+		class Reader
+		{
+		public:
+			explicit Reader(std::span<const std::byte> a_data) :
+				_data(a_data)
+			{}
+
+			template <class T>
+			T read()
+			{
+				T value{};
+				if (_pos + sizeof(T) > _data.size()) {
+					_fail = true;
+					_pos = _data.size();
+					return value;
+				}
+				std::memcpy(&value, _data.data() + _pos, sizeof(T));
+				_pos += sizeof(T);
+				return value;
+			}
+
+			std::string_view read_string(std::size_t a_length)
+			{
+				if (_pos + a_length > _data.size()) {
+					_fail = true;
+					_pos = _data.size();
+					return {};
+				}
+				const std::string_view str{ reinterpret_cast<const char*>(_data.data() + _pos), a_length };
+				_pos += a_length;
+				return str;
+			}
+
+			std::string_view read_sized_string() { return read_string(read<std::uint32_t>()); }
+			std::string_view read_export_string() { return read_string(read<std::uint8_t>()); }
+
+			void skip(std::size_t a_bytes)
+			{
+				if (_pos + a_bytes > _data.size()) {
+					_fail = true;
+					_pos = _data.size();
+				} else {
+					_pos += a_bytes;
+				}
+			}
+
+			void seek(std::size_t a_pos)
+			{
+				if (a_pos > _data.size()) {
+					_fail = true;
+					_pos = _data.size();
+				} else {
+					_pos = a_pos;
+				}
+			}
+
+			[[nodiscard]] std::size_t size() const { return _data.size(); }
+			[[nodiscard]] std::size_t tell() const { return _pos; }
+			[[nodiscard]] bool fail() const { return _fail; }
+
+		private:
+			std::span<const std::byte> _data;
+			std::size_t _pos{ 0 };
+			bool _fail{ false };
+		};
+
+		constexpr std::uint32_t SSE_VERSION{ 0x14020007 };  //20.2.0.7
+		constexpr std::uint32_t SSE_BS_VERSION{ 100 };
+
+		constexpr std::uint32_t SKINNED_FLAG{ 1 << 1 };  //SLSF1_Skinned
+		constexpr std::uint16_t ALPHA_BLEND_FLAG{ 1 << 0 };
+		constexpr std::uint16_t ALPHA_TEST_FLAG{ 1 << 9 };
+
+		constexpr std::array nodeTypes{
+			"NiNode"sv,
+			"BSFadeNode"sv,
+			"BSLeafAnimNode"sv,
+			"BSTreeNode"sv,
+			"BSMultiBoundNode"sv,
+			"BSOrderedNode"sv,
+			"BSValueNode"sv,
+			"BSBlastNode"sv,
+			"BSDamageStage"sv,
+			"BSDebrisNode"sv,
+			"BSRangeNode"sv,
+			"NiBillboardNode"sv,
+			"NiSwitchNode"sv,
+			"NiLODNode"sv
+		};
+		//subclasses of BSFadeNode
+		constexpr std::array fadeNodeTypes{
+			"BSFadeNode"sv,
+			"BSLeafAnimNode"sv,
+			"BSTreeNode"sv
+		};
+		//subclasses of BSTriShape
+		constexpr std::array triShapeTypes{
+			"BSTriShape"sv,
+			"BSSubIndexTriShape"sv,
+			"BSMeshLODTriShape"sv,
+			"BSLODTriShape"sv,
+			"BSDynamicTriShape"sv
+		};
+
+		template <std::size_t N>
+		bool is_any_of(std::string_view a_type, const std::array<std::string_view, N>& a_types)
+		{
+			return std::ranges::find(a_types, a_type) != a_types.end();
+		}
+
+		struct Block
+		{
+			std::string_view type;
+			std::size_t offset;
+			std::size_t size;
+		};
+
+		class File
+		{
+		public:
+			explicit File(std::span<const std::byte> a_data) :
+				_reader(a_data)
+			{}
+
+			bool ReadHeader();
+			RESULT Classify();
+
+		private:
+			struct Verdict
+			{
+				bool hasShape{ false };
+				bool fail{ false };
+				bool unknown{ false };
+			};
+
+			void skip_object_net()
+			{
+				_reader.skip(4);  //name
+				_reader.skip(static_cast<std::size_t>(_reader.read<std::uint32_t>()) * 4);
+				_reader.skip(4);  //controller
+			}
+
+			void skip_av_object()
+			{
+				skip_object_net();
+				_reader.skip(4 + 12 + 36 + 4 + 4);  //flags, translation, rotation, scale, collision
+			}
+
+			[[nodiscard]] const Block* get_block(std::int32_t a_ref) const
+			{
+				return a_ref >= 0 && static_cast<std::size_t>(a_ref) < _blocks.size() ? &_blocks[a_ref] : nullptr;
+			}
+
+			void VisitNode(std::int32_t a_ref, bool a_hasFadeNode, Verdict& a_verdict);
+			void VisitGeometry(const Block& a_block, bool a_hasFadeNode, Verdict& a_verdict);
+
+			Reader _reader;
+			std::vector<Block> _blocks;
+			std::vector<std::int32_t> _roots;
+			std::vector<bool> _visited;
+		};
+
+		bool File::ReadHeader()
+		{
+			constexpr auto magic = "Gamebryo File Format, Version "sv;
+
+			std::size_t lineLength = 0;
+			{
+				Reader probe = _reader;
+				while (!probe.fail() && probe.read<char>() != '\n') {
+					++lineLength;
+				}
+				if (probe.fail() || !_reader.read_string(lineLength).starts_with(magic)) {
+					return false;
+				}
+				_reader.skip(1);
+			}
+
+			if (_reader.read<std::uint32_t>() != SSE_VERSION || _reader.read<std::uint8_t>() != 1) {
+				return false;
+			}
+
+			const auto userVersion = _reader.read<std::uint32_t>();
+			const auto numBlocks = _reader.read<std::uint32_t>();
+			if (userVersion < 10 || _reader.read<std::uint32_t>() != SSE_BS_VERSION || numBlocks == 0 || numBlocks > _reader.size()) {
+				return false;
+			}
+
+			_reader.read_export_string();  //author
+			_reader.read_export_string();  //process script
+			_reader.read_export_string();  //export script
+
+			const auto numBlockTypes = _reader.read<std::uint16_t>();
+			std::vector<std::string_view> blockTypes(numBlockTypes);
+			for (auto& blockType : blockTypes) {
+				blockType = _reader.read_sized_string();
+			}
+
+			if (_reader.fail()) {
+				return false;
+			}
+
+			_blocks.resize(numBlocks);
+			for (auto& block : _blocks) {
+				const auto typeIndex = static_cast<std::uint16_t>(_reader.read<std::uint16_t>() & 0x7FFF);
+				if (typeIndex >= blockTypes.size()) {
+					return false;
+				}
+				block.type = blockTypes[typeIndex];
+			}
+			for (auto& block : _blocks) {
+				block.size = _reader.read<std::uint32_t>();
+			}
+
+			const auto numStrings = _reader.read<std::uint32_t>();
+			_reader.skip(4);  //max string length
+			for (std::uint32_t i = 0; i < numStrings && !_reader.fail(); ++i) {
+				_reader.read_sized_string();
+			}
+			_reader.skip(static_cast<std::size_t>(_reader.read<std::uint32_t>()) * 4);  //groups
+
+			auto offset = _reader.tell();
+			for (auto& block : _blocks) {
+				block.offset = offset;
+				offset += block.size;
+			}
+
+			_reader.seek(offset);
+			const auto numRoots = _reader.read<std::uint32_t>();
+			for (std::uint32_t i = 0; i < numRoots && !_reader.fail(); ++i) {
+				_roots.push_back(_reader.read<std::int32_t>());
+			}
+			if (_reader.fail() || _roots.empty()) {
+				_roots = { 0 };
+			}
+
+			_visited.resize(_blocks.size());
+
+			return !_blocks.empty();
+		}
+
+		void File::VisitGeometry(const Block& a_block, bool a_hasFadeNode, Verdict& a_verdict)
+		{
+			a_verdict.hasShape = true;
+
+			_reader.seek(a_block.offset);
+			skip_av_object();
+			_reader.skip(16);  //bounding sphere
+			_reader.skip(4);   //skin
+			const auto shaderRef = _reader.read<std::int32_t>();
+			const auto alphaRef = _reader.read<std::int32_t>();
+			_reader.skip(8);  //vertex desc
+			_reader.skip(2);  //triangles
+			const auto numVertices = _reader.read<std::uint16_t>();
+
+			if (_reader.fail()) {
+				a_verdict.unknown = true;
+				return;
+			}
+
+			if (numVertices == 0 || !a_hasFadeNode) {
+				a_verdict.fail = true;
+				return;
+			}
+
+			const auto shader = get_block(shaderRef);
+			if (!shader || shader->type != "BSLightingShaderProperty"sv) {
+				a_verdict.fail = true;
+				return;
+			}
+
+			_reader.seek(shader->offset);
+			_reader.skip(4);  //shader type, precedes NiObjectNET for lighting shaders
+			skip_object_net();
+			const auto shaderFlags1 = _reader.read<std::uint32_t>();
+			if (_reader.fail()) {
+				a_verdict.unknown = true;
+				return;
+			}
+			if ((shaderFlags1 & SKINNED_FLAG) != 0) {
+				a_verdict.fail = true;
+				return;
+			}
+
+			if (const auto alpha = get_block(alphaRef); alpha && alpha->type == "NiAlphaProperty"sv) {
+				_reader.seek(alpha->offset);
+				skip_object_net();
+				const auto alphaFlags = _reader.read<std::uint16_t>();
+				if (_reader.fail()) {
+					a_verdict.unknown = true;
+					return;
+				}
+				if ((alphaFlags & (ALPHA_BLEND_FLAG | ALPHA_TEST_FLAG)) != 0) {
+					a_verdict.fail = true;
+				}
+			}
+		}
+
+		void File::VisitNode(std::int32_t a_ref, bool a_hasFadeNode, Verdict& a_verdict)
+		{
+			const auto block = get_block(a_ref);
+			if (!block || _visited[a_ref]) {
+				return;
+			}
+			_visited[a_ref] = true;
+
+			if (is_any_of(block->type, triShapeTypes)) {
+				VisitGeometry(*block, a_hasFadeNode, a_verdict);
+				return;
+			}
+
+			if (!is_any_of(block->type, nodeTypes)) {
+				a_verdict.unknown = true;  //particles, legacy NiTriShapes, etc
+				return;
+			}
+
+			const bool hasFadeNode = a_hasFadeNode || is_any_of(block->type, fadeNodeTypes);
+
+			_reader.seek(block->offset);
+			skip_av_object();
+			const auto numChildren = _reader.read<std::uint32_t>();
+			if (_reader.fail() || numChildren > _blocks.size()) {
+				a_verdict.unknown = true;
+				return;
+			}
+
+			std::vector<std::int32_t> children(numChildren);
+			for (auto& child : children) {
+				child = _reader.read<std::int32_t>();
+			}
+			if (_reader.fail()) {
+				a_verdict.unknown = true;
+				return;
+			}
+
+			for (const auto child : children) {
+				VisitNode(child, hasFadeNode, a_verdict);
+				if (a_verdict.fail || a_verdict.unknown) {
+					return;
+				}
+			}
+		}
+
+		RESULT File::Classify()
+		{
+			Verdict verdict;
+			for (const auto root : _roots) {
+				VisitNode(root, false, verdict);
+				if (verdict.fail || verdict.unknown) {
+					break;
+				}
+			}
+
+			if (verdict.unknown) {
+				return RESULT::kUnknown;
+			}
+			return verdict.hasShape && !verdict.fail ? RESULT::kMultiPass : RESULT::kSinglePass;
+		}
+	}
+
+	RESULT Scan(std::span<const std::byte> a_data)
+	{
+		detail::File file{ a_data };
+		return file.ReadHeader() ? file.Classify() : RESULT::kUnknown;
+	}
+
+	RESULT Scan(const std::filesystem::path& a_path)
+	{
+		const MappedFile file{ a_path };
+		return file.is_open() ? Scan(file.data()) : RESULT::kUnknown;
+	}
+}
@@ -1,5 +1,8 @@
 #include "Papyrus.h"
+#include "Capture.h"
+#include "Profiler.h"
 #include "SeasonManager.h"
+#include "SwapMemo.h"
 
 namespace Papyrus
 {
@@ -63,6 +66,26 @@ namespace Papyrus
 			SeasonManager::GetSingleton()->SetSeasonOverride(SEASON::kNone);
 		}
 
+		void DumpProfilerStats(VM*, StackID, RE::StaticFunctionTag*)
+		{
+			Profiler::Dump();
+			SwapMemo::Manager::GetSingleton()->LogStatistics();
+		}
+
+		void LogMemoryUsage(VM*, StackID, RE::StaticFunctionTag*)
+		{
+			memory::log_plugin_stats();
+		}
+
+		void StartHookCapture(VM*, StackID, RE::StaticFunctionTag*)
+		{
+			Capture::Manager::GetSingleton()->Start();
+		}
+		void StopHookCapture(VM*, StackID, RE::StaticFunctionTag*)
+		{
+			Capture::Manager::GetSingleton()->Stop();
+		}
+
 		void Bind(VM& a_vm)
 		{
 			constexpr auto script = "SeasonsOfSkyrim"sv;
@@ -81,6 +104,11 @@ namespace Papyrus
 			a_vm.RegisterFunction("UnregisterForSeasonChange_AME", script, UnregisterForSeasonChange_AME);
 			a_vm.RegisterFunction("UnregisterForSeasonChange_Form", script, UnregisterForSeasonChange_Form);
 
+			a_vm.RegisterFunction("DumpProfilerStats", script, DumpProfilerStats);
+			a_vm.RegisterFunction("LogMemoryUsage", script, LogMemoryUsage);
+			a_vm.RegisterFunction("StartHookCapture", script, StartHookCapture);
+			a_vm.RegisterFunction("StopHookCapture", script, StopHookCapture);
+
 			logger::info("Registered season functions"sv);
 		}
 	}
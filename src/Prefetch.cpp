@@ -0,0 +1,341 @@
+#include "Prefetch.h"
+#include "CellIndex.h"
+#include "Scheduler.h"
+#include "SeasonManager.h"
+#include "SnowSwap.h"
+#include "LODSwap.h"
+
+namespace Prefetch
+{
+	void Manager::LoadSettings(CSimpleIniA& a_ini)
+	{
+		INI::get_value(a_ini, settings.hours, "Performance", "Prefetch Hours", ";Read the next season's models and LOD this many game hours before the season changes. 0 - disabled.");
+
+		INI::get_value(a_ini, settings.preloadModels, "Performance", "Preload Swap Models", ";Load the next season's models in the background before they are needed : ahead of the month boundary, and when a door leads into a new season.");
+
+		logger::info("prefetch : {} hours before season change", settings.hours);
+		logger::info("preload swap models : {}", settings.preloadModels);
+	}
+
+	void Manager::CollectModels(SEASON a_nextSeason, const SEASON_DELTA& a_delta, const Set<RE::FormID>& a_bases, std::vector<std::string>& a_paths)
+	{
+		const auto seasonManager = SeasonManager::GetSingleton();
+
+		Set<std::string> uniquePaths;
+		for (const auto& baseID : a_bases) {
+			if (!a_delta.bases.contains(baseID)) {
+				continue;
+			}
+			const auto base = RE::TESForm::LookupByID(baseID);
+			const auto swapBase = base ? seasonManager->GetSwapForm(a_nextSeason, base) : nullptr;
+			if (const auto model = swapBase ? swapBase->As<RE::TESModel>() : nullptr) {
+				if (const auto path = model::normalize_model_path(model->GetModel()); !path.empty()) {
+					uniquePaths.emplace(fmt::format(R"(Meshes\{})", path));
+				}
+			}
+		}
+
+		a_paths.insert(a_paths.end(), uniquePaths.begin(), uniquePaths.end());
+	}
+
+	void Manager::CollectLandTextures(SEASON a_nextSeason, const SEASON_DELTA& a_delta, std::vector<std::string>& a_paths)
+	{
+		const auto seasonManager = SeasonManager::GetSingleton();
+
+		Set<std::string> uniquePaths;
+		for (const auto& landTextureID : a_delta.landTextures) {
+			const auto landTexture = RE::TESForm::LookupByID<RE::TESLandTexture>(landTextureID);
+			const auto swapLT = landTexture ? seasonManager->GetSwapLandTexture(a_nextSeason, landTexture) : nullptr;
+			if (const auto txst = swapLT ? swapLT->textureSet : nullptr) {
+				for (const auto& texture : { RE::BGSTextureSet::Texture::kDiffuse, RE::BGSTextureSet::Texture::kNormal }) {
+					if (const auto path = txst->GetTexturePath(texture); path && *path != '\0') {
+						uniquePaths.emplace(fmt::format(R"(Textures\{})", path));
+					}
+				}
+			}
+		}
+
+		a_paths.insert(a_paths.end(), uniquePaths.begin(), uniquePaths.end());
+	}
+
+	void Manager::CollectLOD(SEASON a_season, const RE::TESWorldSpace* a_worldSpace, const RE::NiPoint3& a_pos, std::vector<std::string>& a_paths)
+	{
+		const auto seasonManager = SeasonManager::GetSingleton();
+
+		const auto editorID = a_worldSpace ? a_worldSpace->GetFormEditorID() : nullptr;
+		if (!editorID || *editorID == '\0') {
+			return;
+		}
+
+		const auto [terrain, terrainSuffix] = seasonManager->CanSwapLOD(a_season, LOD_TYPE::kTerrain, a_worldSpace);
+		const auto [object, objectSuffix] = seasonManager->CanSwapLOD(a_season, LOD_TYPE::kObject, a_worldSpace);
+		const auto [tree, treeSuffix] = seasonManager->CanSwapLOD(a_season, LOD_TYPE::kTree, a_worldSpace);
+
+		if (object) {
+			a_paths.emplace_back(LODSwap::detail::get_seasonal_lod_filename<LODSwap::Object::BuildDiffuseTextureAtlasFileName>(objectSuffix, editorID));
+			a_paths.emplace_back(LODSwap::detail::get_seasonal_lod_filename<LODSwap::Object::BuildNormalTextureAtlasFileName>(objectSuffix, editorID));
+		}
+		if (tree) {
+			a_paths.emplace_back(LODSwap::detail::get_seasonal_lod_filename<LODSwap::Tree::BuildTextureFileName>(treeSuffix, editorID));
+			a_paths.emplace_back(LODSwap::detail::get_seasonal_lod_filename<LODSwap::Tree::BuildTypeListFileName>(treeSuffix, editorID));
+		}
+
+		if (!terrain && !object && !tree) {
+			return;
+		}
+
+		struct Quad
+		{
+			float distance;
+			std::uint32_t level;
+			std::int32_t x;
+			std::int32_t y;
+		};
+
+		constexpr std::array<std::uint32_t, 4> levels{ 4, 8, 16, 32 };
+		constexpr std::int32_t radius = 2;  //quads around the one containing the position, per level
+		constexpr float cellSize = 4096.0f;
+
+		const auto cellX = a_pos.x / cellSize;
+		const auto cellY = a_pos.y / cellSize;
+
+		std::vector<Quad> quads;
+		quads.reserve(levels.size() * (radius * 2 + 1) * (radius * 2 + 1));
+
+		for (const auto level : levels) {
+			const auto size = static_cast<float>(level);
+			const auto originX = static_cast<std::int32_t>(std::floor(cellX / size)) * static_cast<std::int32_t>(level);
+			const auto originY = static_cast<std::int32_t>(std::floor(cellY / size)) * static_cast<std::int32_t>(level);
+
+			for (std::int32_t i = -radius; i <= radius; ++i) {
+				for (std::int32_t j = -radius; j <= radius; ++j) {
+					const auto x = originX + i * static_cast<std::int32_t>(level);
+					const auto y = originY + j * static_cast<std::int32_t>(level);
+					//closest point of the quad
+					const auto dx = std::max({ static_cast<float>(x) - cellX, 0.0f, cellX - static_cast<float>(x) - size });
+					const auto dy = std::max({ static_cast<float>(y) - cellY, 0.0f, cellY - static_cast<float>(y) - size });
+					quads.push_back({ std::sqrt(dx * dx + dy * dy), level, x, y });
+				}
+			}
+		}
+
+		std::ranges::sort(quads, [](const Quad& a_lhs, const Quad& a_rhs) {
+			return a_lhs.distance != a_rhs.distance ? a_lhs.distance < a_rhs.distance : a_lhs.level < a_rhs.level;
+		});
+
+		for (const auto& [distance, level, x, y] : quads) {
+			if (terrain) {
+				a_paths.emplace_back(LODSwap::detail::get_seasonal_lod_filename<LODSwap::Terrain::BuildMeshFileName>(terrainSuffix, editorID, x, y, level));
+				a_paths.emplace_back(LODSwap::detail::get_seasonal_lod_filename<LODSwap::Terrain::BuildDiffuseTextureFileName>(terrainSuffix, editorID, x, y, level));
+				a_paths.emplace_back(LODSwap::detail::get_seasonal_lod_filename<LODSwap::Terrain::BuildNormalTextureFileName>(terrainSuffix, editorID, x, y, level));
+			}
+			if (object) {
+				a_paths.emplace_back(LODSwap::detail::get_seasonal_lod_filename<LODSwap::Object::BuildMeshFileName>(objectSuffix, editorID, x, y, level));
+			}
+			if (tree && level == 4) {
+				a_paths.emplace_back(LODSwap::detail::get_seasonal_lod_filename<LODSwap::Tree::BuildMeshFileName>(treeSuffix, editorID, x, y, level));
+			}
+		}
+	}
+
+	void Manager::Read(std::vector<std::string> a_paths, std::string a_reason)
+	{
+		if (a_paths.empty() || running.exchange(true)) {
+			return;
+		}
+
+		logger::info("Prefetch : reading {} files for {} in background", a_paths.size(), a_reason);
+
+		_reader.Queue([this, paths = std::move(a_paths)]() {
+			const auto start = std::chrono::steady_clock::now();
+
+			std::size_t found = 0;
+			std::size_t bytes = 0;
+			for (const auto& path : paths) {
+				if (const auto size = resource::prefetch_file(path); size > 0) {
+					found++;
+					bytes += size;
+				}
+			}
+
+			const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+			logger::info("Prefetch : read {}/{} files ({:.2f} MB) in {} ms", found, paths.size(), bytes / (1024.0 * 1024.0), elapsed.count());
+
+			running = false;
+		});
+	}
+
+	void Manager::Start(SEASON a_currentSeason, SEASON a_nextSeason)
+	{
+		const auto& delta = SeasonManager::GetSingleton()->GetSeasonDelta(a_currentSeason, a_nextSeason);
+		const auto bufferedBases = CellIndex::Manager::GetSingleton()->GetBufferedBases();
+
+		//loaded before the boundary, so the cells reloading at the switch find them in the model database
+		StartPreload(a_nextSeason, bufferedBases);
+
+		std::vector<std::string> paths;
+		CollectModels(a_nextSeason, delta, bufferedBases, paths);
+
+		if (const auto player = RE::PlayerCharacter::GetSingleton(); SeasonManager::GetSingleton()->GetExterior()) {
+			CollectLOD(a_nextSeason, RE::TES::GetSingleton()->worldSpace, player->GetPosition(), paths);
+		}
+
+		Read(std::move(paths), fmt::format("upcoming season {}", stl::to_underlying(a_nextSeason)));
+	}
+
+	void Manager::PrefetchDestination(SEASON a_currentSeason, SEASON a_nextSeason, const RE::TESWorldSpace* a_worldSpace, const RE::NiPoint3& a_pos)
+	{
+		if (!a_worldSpace) {
+			return;
+		}
+
+		const auto& delta = SeasonManager::GetSingleton()->GetSeasonDelta(a_currentSeason, a_nextSeason);
+
+		//cells of the destination grid that were indexed earlier
+		const auto gridsToLoad = RE::INISettingCollection::GetSingleton()->GetSetting("uGridsToLoad:General");
+		const auto radius = static_cast<std::int32_t>(gridsToLoad ? gridsToLoad->GetUInt() : 5) / 2;
+
+		const auto cells = CellIndex::Manager::GetSingleton()->GetCellsInGrid(
+			a_worldSpace->GetFormID(),
+			static_cast<std::int32_t>(std::floor(a_pos.x / 4096.0f)),
+			static_cast<std::int32_t>(std::floor(a_pos.y / 4096.0f)),
+			radius);
+
+		Set<RE::FormID> swappableBases;
+		Set<RE::FormID> snowBases;
+		for (const auto& cell : cells) {
+			swappableBases.insert(cell.swappableBases.begin(), cell.swappableBases.end());
+			snowBases.insert(cell.snowBases.begin(), cell.snowBases.end());
+		}
+
+		if (a_nextSeason == SEASON::kWinter && !snowBases.empty()) {
+			SnowSwap::Manager::GetSingleton()->PrecomputeSnowTypes(snowBases);
+		}
+
+		//the load screen hasn't started yet, the destination cells queue their models after this
+		StartPreload(a_nextSeason, swappableBases);
+
+		std::vector<std::string> paths;
+		CollectModels(a_nextSeason, delta, swappableBases, paths);
+		CollectLandTextures(a_nextSeason, delta, paths);
+		CollectLOD(a_nextSeason, a_worldSpace, a_pos, paths);
+
+		Read(std::move(paths), fmt::format("destination ({} known cells)", cells.size()));
+	}
+
+	void Manager::StartPreload(SEASON a_season, const Set<RE::FormID>& a_bases)
+	{
+		if (!settings.preloadModels || preloading) {
+			return;
+		}
+
+		const auto seasonManager = SeasonManager::GetSingleton();
+
+		Map<RE::FormID, std::string> models;
+		for (const auto& baseID : a_bases) {
+			const auto base = RE::TESForm::LookupByID(baseID);
+			const auto swapBase = base ? seasonManager->GetSwapForm(a_season, base) : nullptr;
+			if (const auto model = swapBase ? swapBase->As<RE::TESModel>() : nullptr; model && !models.contains(swapBase->GetFormID())) {
+				if (auto path = model::normalize_model_path(model->GetModel()); !path.empty()) {
+					models.emplace(swapBase->GetFormID(), std::move(path));
+				}
+			}
+		}
+
+		if (const auto warm = _warmLoads.exchange(0), cold = _coldLoads.exchange(0); warm + cold > 0) {
+			logger::info("Preload : {} swapped loads were warm, {} cold", warm, cold);
+		}
+
+		{
+			Locker locker(_preloadLock);
+			_preloadedBases.clear();
+			_preloadedModels.clear();
+		}
+
+		if (models.empty()) {
+			return;
+		}
+
+		logger::info("Preload : requesting {} swap target models", models.size());
+
+		preloading = true;
+		_preloader.Queue([this, models = std::move(models)]() {
+			const auto start = std::chrono::steady_clock::now();
+
+			std::size_t loaded = 0;
+			for (const auto& [baseID, path] : models) {
+				RE::NiPointer<RE::NiNode> model;
+				RE::BSModelDB::DBTraits::ArgsType args{};
+				if (RE::BSModelDB::Demand(path.c_str(), model, args) == RE::BSResource::ErrorCode::kNone && model) {
+					Locker locker(_preloadLock);
+					_preloadedBases.emplace(baseID);
+					_preloadedModels.emplace_back(std::move(model));
+					loaded++;
+				}
+			}
+
+			const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+			logger::info("Preload : loaded {}/{} models in {} ms", loaded, models.size(), elapsed.count());
+
+			preloading = false;
+		});
+	}
+
+	void Manager::GetMemoryUsage(std::vector<memory::TableStats>& a_stats) const
+	{
+		ReadLocker locker(_preloadLock);
+		a_stats.push_back(memory::get_table_stats("preloaded bases", _preloadedBases));
+		a_stats.push_back(memory::get_vector_stats("preloaded models", _preloadedModels));
+	}
+
+	void Manager::RecordSwappedLoad(const RE::TESBoundObject* a_swapBase)
+	{
+		if (!settings.preloadModels || !a_swapBase) {
+			return;
+		}
+
+		ReadLocker locker(_preloadLock);
+		if (_preloadedBases.contains(a_swapBase->GetFormID())) {
+			++_warmLoads;
+		} else {
+			++_coldLoads;
+		}
+	}
+
+	void Manager::Register()
+	{
+		Scheduler::Manager::GetSingleton()->Queue("prefetch", Scheduler::PRIORITY::kLow, [this](float) {
+			Update();
+			return false;
+		});
+	}
+
+	void Manager::Update()
+	{
+		if (settings.hours <= 0.0f || running) {
+			return;
+		}
+
+		//game time moves slowly enough that checking every few seconds is plenty
+		const auto now = std::chrono::steady_clock::now();
+		if (now - lastCheck < std::chrono::seconds(5)) {
+			return;
+		}
+		lastCheck = now;
+
+		const auto seasonManager = SeasonManager::GetSingleton();
+
+		const auto nextChange = seasonManager->GetNextSeasonChange();
+		if (!nextChange) {
+			return;
+		}
+
+		const auto& [nextSeason, hours] = *nextChange;
+		if (hours > settings.hours || nextSeason == prefetchedSeason) {
+			return;
+		}
+
+		prefetchedSeason = nextSeason;
+		Start(seasonManager->GetCurrentSeasonType(), nextSeason);
+	}
+}
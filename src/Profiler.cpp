@@ -0,0 +1,211 @@
+#include "Profiler.h"
+
+namespace Profiler
+{
+#ifdef SOS_PROFILER
+	namespace detail
+	{
+		struct Registry
+		{
+			std::mutex lock;
+			std::vector<std::unique_ptr<ThreadCounters>> threads;
+		};
+
+		Registry& get_registry()
+		{
+			static Registry registry;
+			return registry;
+		}
+
+		struct Calibration
+		{
+			std::uint64_t tsc{ 0 };
+			std::chrono::steady_clock::time_point time{};
+		};
+
+		Calibration& get_calibration()
+		{
+			static Calibration calibration;
+			return calibration;
+		}
+
+		//timestamp counter ticks per nanosecond, measured since Init
+		double get_ticks_per_ns()
+		{
+			const auto& [tsc, time] = get_calibration();
+			const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - time).count();
+
+			return tsc && elapsed > 0.0 ? static_cast<double>(__rdtsc() - tsc) / elapsed : 1.0;
+		}
+
+		constexpr std::array hookNames{
+			"FormSwap::GetHandle"sv,
+			"LandscapeSwap::Texture::IsConsideredSnow"sv,
+			"LandscapeSwap::Texture::GetSpecularComponent"sv,
+			"LandscapeSwap::Texture::GetAsShaderTextureSet"sv,
+			"LandscapeSwap::Grass::GetGrassList"sv,
+			"LandscapeSwap::Material::GetHavokMaterialType"sv,
+			"SnowSwap::Statics::Clone3D"sv,
+			"SnowSwap::OtherForms::Clone3D"sv,
+			"LODSwap::Terrain"sv,
+			"LODSwap::Object"sv,
+			"LODSwap::Tree"sv
+		};
+		static_assert(hookNames.size() == stl::to_underlying(HOOK::kTotal));
+
+		constexpr std::array lookupNames{
+			"FormSwap"sv,
+			"LandTexture"sv
+		};
+		static_assert(lookupNames.size() == stl::to_underlying(LOOKUP::kTotal));
+
+		struct HookTotals
+		{
+			std::uint64_t calls{ 0 };
+			std::uint64_t cycles{ 0 };
+			std::uint64_t maxCycles{ 0 };
+			std::array<std::uint64_t, numBuckets> buckets{};
+
+			//upper bound of the bucket holding the percentile, in cycles
+			[[nodiscard]] std::uint64_t percentile(double a_fraction) const
+			{
+				const auto target = static_cast<std::uint64_t>(std::ceil(static_cast<double>(calls) * a_fraction));
+
+				std::uint64_t count = 0;
+				for (std::size_t i = 0; i < numBuckets; ++i) {
+					count += buckets[i];
+					if (count >= target) {
+						return std::uint64_t(1) << i;
+					}
+				}
+				return maxCycles;
+			}
+		};
+
+		struct LookupTotals
+		{
+			std::uint64_t hits{ 0 };
+			std::uint64_t misses{ 0 };
+
+			[[nodiscard]] double hit_rate() const
+			{
+				const auto total = hits + misses;
+				return total ? 100.0 * static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+			}
+		};
+
+		std::pair<std::array<HookTotals, stl::to_underlying(HOOK::kTotal)>, std::array<LookupTotals, stl::to_underlying(LOOKUP::kTotal)>> collect(std::size_t& a_numThreads)
+		{
+			std::array<HookTotals, stl::to_underlying(HOOK::kTotal)> hooks{};
+			std::array<LookupTotals, stl::to_underlying(LOOKUP::kTotal)> lookups{};
+
+			auto& registry = get_registry();
+			std::scoped_lock locker(registry.lock);
+
+			a_numThreads = registry.threads.size();
+
+			for (const auto& thread : registry.threads) {
+				for (std::size_t i = 0; i < hooks.size(); ++i) {
+					const auto& counters = thread->hooks[i];
+					hooks[i].calls += counters.calls.load(std::memory_order_relaxed);
+					hooks[i].cycles += counters.cycles.load(std::memory_order_relaxed);
+					hooks[i].maxCycles = std::max(hooks[i].maxCycles, counters.maxCycles.load(std::memory_order_relaxed));
+					for (std::size_t j = 0; j < numBuckets; ++j) {
+						hooks[i].buckets[j] += counters.buckets[j].load(std::memory_order_relaxed);
+					}
+				}
+				for (std::size_t i = 0; i < lookups.size(); ++i) {
+					lookups[i].hits += thread->lookups[i].hits.load(std::memory_order_relaxed);
+					lookups[i].misses += thread->lookups[i].misses.load(std::memory_order_relaxed);
+				}
+			}
+
+			return { hooks, lookups };
+		}
+	}
+
+	ThreadCounters& get_thread_counters()
+	{
+		thread_local ThreadCounters* counters = [] {
+			auto& registry = detail::get_registry();
+			std::scoped_lock locker(registry.lock);
+			return registry.threads.emplace_back(std::make_unique<ThreadCounters>()).get();
+		}();
+		return *counters;
+	}
+
+	void Init()
+	{
+		detail::get_calibration() = { __rdtsc(), std::chrono::steady_clock::now() };
+
+		//statics are destroyed in reverse order of construction, interleaved with atexit handlers.
+		//construct the registry before registering Dump, so it's still alive when Dump runs
+		detail::get_registry();
+		std::atexit(Dump);
+
+		logger::info("Profiler enabled"sv);
+	}
+
+	void Dump()
+	{
+		std::size_t numThreads = 0;
+		const auto [hooks, lookups] = detail::collect(numThreads);
+
+		const auto ticksPerNs = detail::get_ticks_per_ns();
+		const auto to_ns = [&](std::uint64_t a_cycles) {
+			return static_cast<double>(a_cycles) / ticksPerNs;
+		};
+
+		logger::info("{:*^30}", "PROFILER");
+		logger::info("{} threads, {:.3f} ticks/ns", numThreads, ticksPerNs);
+
+		std::string json = fmt::format("{{\n\t\"threads\": {},\n\t\"ticksPerNs\": {:.3f},\n\t\"hooks\": {{", numThreads, ticksPerNs);
+
+		for (std::size_t i = 0; i < hooks.size(); ++i) {
+			const auto& hook = hooks[i];
+			const auto avg = hook.calls ? to_ns(hook.cycles) / static_cast<double>(hook.calls) : 0.0;
+
+			if (hook.calls) {
+				logger::info("	{} : {} calls, {:.0f} ns avg, p50 < {:.0f} ns, p99 < {:.0f} ns, {:.0f} ns max, {:.3f} ms total",
+					detail::hookNames[i], hook.calls, avg, to_ns(hook.percentile(0.5)), to_ns(hook.percentile(0.99)), to_ns(hook.maxCycles), to_ns(hook.cycles) / 1e6);
+			}
+
+			std::string buckets;
+			for (const auto& bucket : hook.buckets) {
+				buckets += buckets.empty() ? fmt::format("{}", bucket) : fmt::format(", {}", bucket);
+			}
+
+			json += fmt::format("{}\n\t\t\"{}\": {{ \"calls\": {}, \"totalNs\": {:.0f}, \"avgNs\": {:.1f}, \"maxNs\": {:.0f}, \"cycleBuckets\": [{}] }}",
+				i ? "," : "", detail::hookNames[i], hook.calls, to_ns(hook.cycles), avg, to_ns(hook.maxCycles), buckets);
+		}
+
+		json += "\n\t},\n\t\"lookups\": {";
+
+		for (std::size_t i = 0; i < lookups.size(); ++i) {
+			const auto& lookup = lookups[i];
+
+			logger::info("	{} lookups : {} hits, {} misses ({:.1f}% hit rate)", detail::lookupNames[i], lookup.hits, lookup.misses, lookup.hit_rate());
+
+			json += fmt::format("{}\n\t\t\"{}\": {{ \"hits\": {}, \"misses\": {} }}", i ? "," : "", detail::lookupNames[i], lookup.hits, lookup.misses);
+		}
+
+		json += "\n\t}\n}\n";
+
+		if (auto path = logger::log_directory()) {
+			*path /= fmt::format("{}_profile.json", Version::PROJECT);
+			if (std::ofstream file{ *path }; file) {
+				file << json;
+				logger::info("Wrote {}", path->string());
+			}
+		}
+	}
+#else
+	void Init()
+	{}
+
+	void Dump()
+	{
+		logger::info("Profiler is not compiled in, rebuild with ENABLE_PROFILER"sv);
+	}
+#endif
+}
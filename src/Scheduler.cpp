@@ -0,0 +1,167 @@
+#include "Scheduler.h"
+
+namespace Scheduler
+{
+	void Manager::LoadSettings(CSimpleIniA& a_ini)
+	{
+		INI::get_value(a_ini, settings.budget, "Performance", "Frame Budget", ";Time spent per frame on deferred work (incremental transition, queued snow, cache saving), in milliseconds.");
+
+		if (settings.budget <= 0.0f) {
+			settings.budget = 3.0f;
+		}
+
+		logger::info("scheduler budget : {} ms/frame", settings.budget);
+	}
+
+	TaskID Manager::Queue(std::string a_name, PRIORITY a_priority, Task a_task)
+	{
+		Locker locker(_pendingLock);
+
+		const auto id = _nextID++;
+		_pending.emplace_back(a_priority, Entry{ id, std::move(a_name), std::move(a_task) });
+
+		return id;
+	}
+
+	void Manager::Cancel(TaskID a_id)
+	{
+		Locker locker(_pendingLock);
+		std::erase_if(_pending, [&](const auto& a_pending) { return a_pending.second.id == a_id; });
+		_cancelled.push_back(a_id);
+	}
+
+	void Manager::Cancel(std::string_view a_name)
+	{
+		Locker locker(_pendingLock);
+		std::erase_if(_pending, [&](const auto& a_pending) { return a_pending.second.name == a_name; });
+		_cancelledNames.emplace_back(a_name);
+	}
+
+	void Manager::OnQuit(std::function<void()> a_callback)
+	{
+		Locker locker(_pendingLock);
+		_quitCallbacks.push_back(std::move(a_callback));
+	}
+
+	void Manager::Quit()
+	{
+		std::vector<std::function<void()>> callbacks;
+		{
+			Locker locker(_pendingLock);
+			if (std::exchange(_quit, true)) {
+				return;
+			}
+			callbacks = std::move(_quitCallbacks);
+		}
+
+		for (auto& callback : callbacks | std::views::reverse) {
+			callback();
+		}
+	}
+
+	void Manager::CollectPending()
+	{
+		std::vector<std::pair<PRIORITY, Entry>> pending;
+		std::vector<TaskID> cancelled;
+		std::vector<std::string> cancelledNames;
+		{
+			Locker locker(_pendingLock);
+			pending.swap(_pending);
+			cancelled.swap(_cancelled);
+			cancelledNames.swap(_cancelledNames);
+		}
+
+		//pending tasks were already filtered when cancelling
+		if (!cancelled.empty() || !cancelledNames.empty()) {
+			std::size_t numCancelled = 0;
+			for (auto& queue : _queues) {
+				numCancelled += std::erase_if(queue, [&](const Entry& a_entry) {
+					return std::ranges::find(cancelled, a_entry.id) != cancelled.end() ||
+					       std::ranges::find(cancelledNames, a_entry.name) != cancelledNames.end();
+				});
+			}
+
+			Locker locker(_statsLock);
+			_stats.cancelled += numCancelled;
+		}
+
+		for (auto& [priority, entry] : pending) {
+			_queues[stl::to_underlying(priority)].push_back(std::move(entry));
+		}
+	}
+
+	void Manager::Update()
+	{
+		CollectPending();
+
+		using clock = std::chrono::steady_clock;
+		using ms = std::chrono::duration<double, std::milli>;
+
+		const auto frameStart = clock::now();
+		const auto budget = static_cast<double>(settings.budget);
+
+		std::size_t queueDepth = 0;
+
+		for (auto& queue : _queues) {
+			for (auto it = queue.begin(); it != queue.end();) {
+				const auto elapsed = ms(clock::now() - frameStart).count();
+				if (elapsed >= budget) {
+					break;
+				}
+
+				const auto taskStart = clock::now();
+				const auto done = it->task(static_cast<float>(budget - elapsed));
+				const auto taskTime = ms(clock::now() - taskStart).count();
+
+				{
+					Locker locker(_statsLock);
+					auto& taskStats = _stats.tasks[it->name];
+					taskStats.calls++;
+					taskStats.totalTime += taskTime;
+					taskStats.maxTime = std::max(taskStats.maxTime, taskTime);
+				}
+
+				it = done ? queue.erase(it) : std::next(it);
+			}
+			queueDepth += queue.size();
+		}
+
+		const auto frameTime = ms(clock::now() - frameStart).count();
+
+		bool logStats = false;
+		{
+			Locker locker(_statsLock);
+			_stats.frames++;
+			_stats.queueDepth = queueDepth;
+			if (frameTime > budget) {
+				_stats.overruns++;
+
+				//report at most once a minute, and only when something went over
+				if (const auto now = clock::now(); now - _lastStatsLog > std::chrono::minutes(1)) {
+					_lastStatsLog = now;
+					logStats = true;
+				}
+			}
+		}
+
+		if (logStats) {
+			LogStats();
+		}
+	}
+
+	Stats Manager::GetStats() const
+	{
+		Locker locker(_statsLock);
+		return _stats;
+	}
+
+	void Manager::LogStats() const
+	{
+		const auto stats = GetStats();
+
+		logger::info("Scheduler : {} frames, {} over budget, {} tasks cancelled, {} queued", stats.frames, stats.overruns, stats.cancelled, stats.queueDepth);
+		for (const auto& [name, taskStats] : stats.tasks) {
+			logger::info("	{} : {} calls, {:.3f} ms avg, {:.3f} ms max", name, taskStats.calls, taskStats.totalTime / static_cast<double>(taskStats.calls), taskStats.maxTime);
+		}
+	}
+}
@@ -1,5 +1,12 @@
 #include "SeasonManager.h"
+#include "Capture.h"
 #include "Papyrus.h"
+#include "Prefetch.h"
+#include "Profiler.h"
+#include "Scheduler.h"
+#include "SwapMemo.h"
+#include "Trace.h"
+#include "Transition.h"
 
 Season* SeasonManager::GetSeasonImpl(SEASON a_season)
 {
@@ -64,7 +71,7 @@ bool SeasonManager::UpdateSeason()
 			shouldUpdate = seasonOverride != tempLastSeason;
 		}
 		if (!loadedFromSave && shouldUpdate) {
-			Papyrus::Events::Manager::GetSingleton()->seasonChange.QueueEvent(stl::to_underlying(tempLastSeason), stl::to_underlying(seasonOverride), true);
+			QueueSeasonChange(tempLastSeason, seasonOverride, true);
 		}
 
 	} else {
@@ -77,7 +84,7 @@ bool SeasonManager::UpdateSeason()
 			shouldUpdate = currentSeason != lastSeason;
 		}
 		if (!loadedFromSave && shouldUpdate) {
-			Papyrus::Events::Manager::GetSingleton()->seasonChange.QueueEvent(stl::to_underlying(lastSeason), stl::to_underlying(currentSeason), false);
+			QueueSeasonChange(lastSeason, currentSeason, false);
 		}
 	}
 
@@ -88,6 +95,95 @@ bool SeasonManager::UpdateSeason()
 	return shouldUpdate;
 }
 
+std::optional<std::pair<SEASON, float>> SeasonManager::GetNextSeasonChange() const
+{
+	if (seasonType != SEASON_TYPE::kSeasonal || seasonOverride != SEASON::kNone) {
+		return std::nullopt;
+	}
+
+	const auto calendar = RE::Calendar::GetSingleton();
+	if (!calendar) {
+		return std::nullopt;
+	}
+
+	constexpr std::array<std::uint32_t, 12> daysPerMonth{ 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+	const auto get_season = [&](std::uint32_t a_month) {
+		const auto it = monthToSeasons.find(static_cast<MONTH>(a_month));
+		return it != monthToSeasons.end() ? it->second : SEASON::kNone;
+	};
+
+	auto month = calendar->GetMonth() % 12;
+	const auto season = get_season(month);
+
+	//rest of the current month
+	auto hours = (static_cast<float>(daysPerMonth[month]) - std::floor(calendar->GetDay())) * 24.0f + (24.0f - calendar->GetHour());
+
+	for (std::uint32_t i = 0; i < 11; ++i) {
+		month = (month + 1) % 12;
+		if (const auto nextSeason = get_season(month); nextSeason != season) {
+			return std::make_pair(nextSeason, hours);
+		}
+		hours += static_cast<float>(daysPerMonth[month]) * 24.0f;
+	}
+
+	return std::nullopt;
+}
+
+void SeasonManager::QueueSeasonChange(SEASON a_oldSeason, SEASON a_newSeason, bool a_override)
+{
+	detectedSeasonChanges++;
+
+	if (pendingSeasonChange) {
+		pendingSeasonChange->newSeason = a_newSeason;
+		pendingSeasonChange->isOverride = a_override;
+		pendingSeasonChange->count++;
+		pendingSeasonChange->lastChange = std::chrono::steady_clock::now();
+	} else {
+		pendingSeasonChange = PendingSeasonChange{ a_oldSeason, a_newSeason, a_override, 1, std::chrono::steady_clock::now() };
+	}
+}
+
+void SeasonManager::DispatchSeasonChange()
+{
+	if (!pendingSeasonChange || !GetExterior()) {
+		return;
+	}
+
+	const auto& [oldSeason, newSeason, isOverride, count, lastChange] = *pendingSeasonChange;
+	if (std::chrono::steady_clock::now() - lastChange < std::chrono::duration<float, std::milli>(seasonChangeDebounce)) {
+		return;
+	}
+
+	if (oldSeason != newSeason) {
+		Papyrus::Events::Manager::GetSingleton()->seasonChange.QueueEvent(stl::to_underlying(oldSeason), stl::to_underlying(newSeason), isOverride);
+		mergedSeasonChanges += count - 1;
+	} else {
+		mergedSeasonChanges += count;  //ended where it started
+	}
+
+	if (count > 1) {
+		logger::info("Season change : {} -> {}, merged {} changes ({} merged out of {} so far)", stl::to_underlying(oldSeason), stl::to_underlying(newSeason), count, mergedSeasonChanges, detectedSeasonChanges);
+	}
+
+	pendingSeasonChange.reset();
+}
+
+void SeasonManager::RegisterSeasonChangeDispatch()
+{
+	Scheduler::Manager::GetSingleton()->Queue("season change events", Scheduler::PRIORITY::kNormal, [this](float) {
+		DispatchSeasonChange();
+
+		//worldspace changed without going through an interior
+		if (const auto tes = RE::TES::GetSingleton(); tes && GetExterior() && state.load(std::memory_order_relaxed)->worldSpace != tes->worldSpace) {
+			PublishState();
+			SnowSwap::Manager::GetSingleton()->UpdateMultiPassSnow();
+		}
+		return false;
+	});
+}
+
+//may run on any thread, never writes
 Season* SeasonManager::GetSeason()
 {
 	if (!GetExterior()) {
@@ -96,12 +192,77 @@ Season* SeasonManager::GetSeason()
 
 	if (seasonOverride != SEASON::kNone) {
 		return GetSeasonImpl(seasonOverride);
-	} else {
-		if (currentSeason == SEASON::kNone) {
-			UpdateSeason();
+	}
+	return currentSeason == SEASON::kNone ? GetCurrentSeason() : GetSeasonImpl(currentSeason);
+}
+
+const SEASON_STATE* SeasonManager::GetState() const
+{
+	const auto currentState = state.load(std::memory_order_acquire);
+
+	const auto tes = RE::TES::GetSingleton();
+	return tes && currentState->worldSpace == tes->worldSpace ? currentState : nullptr;
+}
+
+void SeasonManager::PublishState()
+{
+	if (GetExterior() && currentSeason == SEASON::kNone && seasonOverride == SEASON::kNone) {
+		UpdateSeason();
+	}
+
+	const auto tes = RE::TES::GetSingleton();
+
+	auto newState = std::make_unique<SEASON_STATE>();
+	newState->worldSpace = tes ? tes->worldSpace : nullptr;
+
+	if (const auto season = GetSeason()) {
+		newState->season = season;
+		newState->type = season->GetType();
+
+		if (season->IsInValidWorldSpace(newState->worldSpace)) {
+			newState->canSwapLandscape = true;
+			newState->canApplySnowShader = newState->type == SEASON::kWinter;
+
+			for (const auto formType : { RE::FormType::Activator, RE::FormType::Furniture, RE::FormType::MovableStatic, RE::FormType::Static, RE::FormType::Tree, RE::FormType::Grass, RE::FormType::Flora, RE::FormType::ReferenceEffect }) {
+				newState->swapFormTypes.set(stl::to_underlying(formType), season->CanSwapForm(formType, newState->worldSpace));
+			}
+			for (const auto lodType : { LOD_TYPE::kTerrain, LOD_TYPE::kObject, LOD_TYPE::kTree }) {
+				newState->swapLOD[stl::to_underlying(lodType)] = season->CanSwapLOD(lodType, newState->worldSpace);
+			}
+		}
+		newState->lodSuffix = season->GetID().suffix;
+
+		if (newState->canSwapLandscape) {
+			newState->landTextures = landTextureTables[stl::to_underlying(newState->type)].data();
 		}
-		return GetSeasonImpl(currentSeason);
 	}
+
+	const auto oldState = state.load(std::memory_order_relaxed);
+	if (oldState->HasSameContents(*newState)) {
+		return;
+	}
+
+	auto it = std::ranges::find_if(internedStates, [&](const auto& a_state) { return a_state->HasSameContents(*newState); });
+	if (it == internedStates.end()) {
+		newState->epoch = static_cast<std::uint32_t>(internedStates.size() + 1);
+		it = internedStates.insert(internedStates.end(), std::move(newState));
+	}
+
+	const auto publishedState = it->get();
+	SwapMemo::Manager::GetSingleton()->OnEpochChange(publishedState->epoch);
+
+	state.store(publishedState, std::memory_order_release);
+}
+
+std::uint32_t SeasonManager::GetStateEpoch() const
+{
+	const auto currentState = GetState();
+	return currentState ? currentState->epoch : 0;
+}
+
+std::uint32_t SeasonManager::GetCellBatchRefs() const
+{
+	return cellBatchRefs;
 }
 
 void SeasonManager::LoadMonthToSeasonMap(CSimpleIniA& a_ini)
@@ -155,6 +316,21 @@ void SeasonManager::LoadSettings()
 	summer.LoadSettings(ini);
 	autumn.LoadSettings(ini);
 
+	bool asyncLogging = false;  //read in SKSEPlugin_Load, before this
+	INI::get_value(ini, asyncLogging, "Performance", "Async Logging", ";Write the log from a background thread, flushed every second and on warnings. Takes effect on the next launch.");
+
+	bool startupTrace = false;  //read in SKSEPlugin_Load, before this
+	INI::get_value(ini, startupTrace, "Performance", "Startup Trace", ";Write startup timings to po3_SeasonsOfSkyrim_trace.json in the log folder (open in chrome://tracing or ui.perfetto.dev). Takes effect on the next launch.");
+
+	INI::get_value(ini, seasonChangeDebounce, "Performance", "Season Change Debounce", ";Season changes closer together than this (in milliseconds) are merged, and OnSeasonChange is sent once.");
+	INI::get_value(ini, cellBatchRefs, "Performance", "Cell Batch Refs", ";Decide all references in a cell at once when it has at least this many references that can change with the season. 0 disables it.\n;Only pays off on very large cells, tests/swapbatch measures the break-even point.");
+
+	Scheduler::Manager::GetSingleton()->LoadSettings(ini);
+	Transition::Manager::GetSingleton()->LoadSettings(ini);
+	SnowSwap::Manager::GetSingleton()->LoadSettings(ini);
+	Prefetch::Manager::GetSingleton()->LoadSettings(ini);
+	Capture::Manager::GetSingleton()->LoadSettings(ini);
+
 	(void)ini.SaveFile(settings);
 }
 
@@ -211,7 +387,10 @@ void SeasonManager::LoadOrGenerateWinterFormSwap()
 	ini.SetMultiKey();
 	ini.SetAllowKeyOnly();
 
-	ini.LoadFile(path);
+	{
+		const Trace::Zone iniZone{ "ini", "io"sv, "Data/Seasons/MainFormSwap_WIN.ini" };
+		ini.LoadFile(path);
+	}
 
 	auto& winFormSwapMap = winter.GetFormSwapMap();
 
@@ -279,6 +458,8 @@ void SeasonManager::LoadOrGenerateWinterFormSwap()
 			if (!values.empty()) {
 				logger::info("	[{}] read {} variants", type, values.size());
 
+				const Trace::Zone typeZone{ "LoadFormSwaps", "startup"sv, type };
+
 				std::vector<std::string> vec;
 				std::ranges::transform(values, std::back_inserter(vec), [&](const auto& val) { return val.pItem; });
 
@@ -294,10 +475,15 @@ void SeasonManager::LoadSeasonData(Season& a_season, CSimpleIniA& a_settings)
 
 	const auto& [type, suffix] = a_season.GetID();
 
-	for (constexpr auto folder = R"(Data\Seasons)"; const auto& entry : std::filesystem::directory_iterator(folder)) {
-		if (entry.exists() && !entry.path().empty() && entry.path().extension() == ".ini"sv) {
-			if (const auto path = entry.path().string(); path.contains(suffix) && !path.contains("MainFormSwap"sv)) {
-				configs.push_back(path);
+	const Trace::Zone seasonZone{ "LoadSeasonData", "startup"sv, type };
+
+	{
+		const Trace::Zone scanZone{ "directory scan", "io"sv, R"(Data\Seasons)" };
+		for (constexpr auto folder = R"(Data\Seasons)"; const auto& entry : std::filesystem::directory_iterator(folder)) {
+			if (entry.exists() && !entry.path().empty() && entry.path().extension() == ".ini"sv) {
+				if (const auto path = entry.path().string(); path.contains(suffix) && !path.contains("MainFormSwap"sv)) {
+					configs.push_back(path);
+				}
 			}
 		}
 	}
@@ -314,6 +500,8 @@ void SeasonManager::LoadSeasonData(Season& a_season, CSimpleIniA& a_settings)
 	for (auto& path : configs) {
 		logger::info("	INI : {}", path);
 
+		const Trace::Zone iniZone{ "ini", "io"sv, path };
+
 		CSimpleIniA ini;
 		ini.SetUnicode();
 		ini.SetMultiKey();
@@ -344,6 +532,128 @@ void SeasonManager::LoadSeasonData()
 	LoadSeasonData(autumn, settingsINI);
 
 	(void)settingsINI.SaveFile(settings);
+
+	BuildSeasonDeltas();
+	BuildLandTextureTables();
+}
+
+void SeasonManager::BuildSeasonDeltas()
+{
+	struct SeasonSwaps
+	{
+		MapPair<RE::FormID> forms{};
+		MapPair<RE::FormID> landTextures{};
+		bool swapGrass{ false };
+	};
+
+	std::array<SeasonSwaps, 5> seasonSwaps{};  //kNone has no swaps
+	ForEachSeason([&](Season& a_season) {
+		auto& swaps = seasonSwaps[stl::to_underlying(a_season.GetType())];
+		swaps.forms = a_season.GetEffectiveSwaps();
+		swaps.landTextures = a_season.GetEffectiveLandTextureSwaps();
+		swaps.swapGrass = a_season.GetEffectiveGrassSwap();
+	});
+
+	constexpr auto get_swap = [](const MapPair<RE::FormID>& a_map, RE::FormID a_form) -> RE::FormID {
+		const auto it = a_map.find(a_form);
+		return it != a_map.end() ? it->second : 0;
+	};
+
+	std::size_t total = 0;
+
+	for (std::size_t oldIdx = 0; oldIdx < seasonSwaps.size(); ++oldIdx) {
+		for (std::size_t newIdx = 0; newIdx < seasonSwaps.size(); ++newIdx) {
+			auto& delta = seasonDeltas[oldIdx][newIdx];
+			delta = {};
+
+			if (oldIdx == newIdx) {
+				continue;
+			}
+
+			const auto& oldSwaps = seasonSwaps[oldIdx];
+			const auto& newSwaps = seasonSwaps[newIdx];
+
+			const auto add_form_delta = [&](const MapPair<RE::FormID>& a_lhs, const MapPair<RE::FormID>& a_rhs) {
+				for (const auto& [base, swap] : a_lhs) {
+					if (get_swap(a_rhs, base) != swap) {
+						delta.bases.emplace(base);
+					}
+				}
+			};
+			add_form_delta(oldSwaps.forms, newSwaps.forms);
+			add_form_delta(newSwaps.forms, oldSwaps.forms);
+
+			const auto add_land_delta = [&](const SeasonSwaps& a_lhs, const SeasonSwaps& a_rhs) {
+				for (const auto& [landTxst, swap] : a_lhs.landTextures) {
+					const auto otherSwap = get_swap(a_rhs.landTextures, landTxst);
+					const auto grassSwap = a_lhs.swapGrass ? swap : 0;
+					const auto otherGrassSwap = a_rhs.swapGrass ? otherSwap : 0;
+					if (otherSwap != swap || otherGrassSwap != grassSwap) {
+						delta.landTextures.emplace(landTxst);
+					}
+				}
+			};
+			add_land_delta(oldSwaps, newSwaps);
+			add_land_delta(newSwaps, oldSwaps);
+
+			total += delta.bases.size() + delta.landTextures.size();
+		}
+	}
+
+	logger::info("Built season delta tables ({} entries)", total);
+	for (const auto season : { SEASON::kWinter, SEASON::kSpring, SEASON::kSummer, SEASON::kAutumn }) {
+		const auto next = season == SEASON::kAutumn ? SEASON::kWinter : static_cast<SEASON>(stl::to_underlying(season) + 1);
+		const auto& delta = GetSeasonDelta(season, next);
+		logger::info("	{} -> {} : {} bases, {} land textures", GetSeasonImpl(season)->GetID().suffix, GetSeasonImpl(next)->GetID().suffix, delta.bases.size(), delta.landTextures.size());
+	}
+}
+
+void SeasonManager::BuildLandTextureTables()
+{
+	landTextureSlots.clear();
+	textureSetSlots.clear();
+	defaultLandTextureSlot.reset();
+
+	std::vector<RE::TESLandTexture*> landTextures;
+	for (const auto& landTexture : RE::TESDataHandler::GetSingleton()->GetFormArray<RE::TESLandTexture>()) {
+		if (!landTexture) {
+			continue;
+		}
+
+		const auto slot = static_cast<std::uint32_t>(landTextures.size());
+		landTextures.push_back(landTexture);
+
+		landTextureSlots.emplace(landTexture->GetFormID(), slot);
+		if (landTexture->textureSet) {
+			textureSetSlots.emplace(landTexture->textureSet->GetFormID(), slot);  //first one wins, same as Cache::DataHolder
+		}
+	}
+
+	if (const auto it = landTextureSlots.find(0x00000C16); it != landTextureSlots.end()) {
+		defaultLandTextureSlot = it->second;
+	}
+
+	ForEachSeason([&](Season& a_season) {
+		auto& table = landTextureTables[stl::to_underlying(a_season.GetType())];
+		table.clear();
+		table.reserve(landTextures.size());
+
+		const auto swapGrass = a_season.GetEffectiveGrassSwap();
+
+		for (const auto& landTexture : landTextures) {
+			const auto swapLT = a_season.GetFormSwapMap().GetSwapLandTexture(landTexture);
+			const auto source = swapLT ? swapLT : landTexture;
+
+			table.push_back({ swapLT ? swapLT->GetFormID() : 0,
+				swapLT ? swapLT->textureSet : nullptr,
+				std::addressof((swapLT && swapGrass ? swapLT : landTexture)->textureGrassList),
+				source->materialType ? source->materialType->materialID : RE::MATERIAL_ID::kNone,
+				static_cast<float>(source->specularExponent),
+				source->shaderTextureIndex != 0 });
+		}
+	});
+
+	logger::info("Built land texture tables ({} land textures, {} texture sets)", landTextureSlots.size(), textureSetSlots.size());
 }
 
 void SeasonManager::SaveSeason(std::string_view a_savePath)
@@ -384,6 +694,8 @@ void SeasonManager::LoadSeason(const std::string& a_savePath)
 
 	loadedFromSave = true;
 
+	PublishState();
+
 	(void)ini.SaveFile(serializedSeasonList);
 }
 
@@ -454,56 +766,172 @@ SEASON SeasonManager::GetCurrentSeasonType()
 
 SEASON SeasonManager::GetSeasonType()
 {
+	if (const auto currentState = GetState()) {
+		return currentState->type;
+	}
+
 	const auto season = GetSeason();
 	return season ? season->GetType() : SEASON::kNone;
 }
 
 bool SeasonManager::CanApplySnowShader()
 {
+	if (const auto currentState = GetState()) {
+		return currentState->canApplySnowShader;
+	}
+
 	const auto season = GetSeason();
 	return season ? season->CanApplySnowShader() : false;
 }
 
 std::pair<bool, std::string> SeasonManager::CanSwapLOD(LOD_TYPE a_type)
 {
+	if (const auto currentState = GetState()) {
+		return std::make_pair(currentState->swapLOD[stl::to_underlying(a_type)], currentState->lodSuffix);
+	}
+
 	const auto season = GetSeason();
 	return season ? std::make_pair(season->CanSwapLOD(a_type), season->GetID().suffix) : std::make_pair(false, "");
 }
 
+std::pair<bool, std::string> SeasonManager::CanSwapLOD(SEASON a_season, LOD_TYPE a_type, const RE::TESWorldSpace* a_worldSpace)
+{
+	const auto season = GetSeasonImpl(a_season);
+	return season ? std::make_pair(season->CanSwapLOD(a_type, a_worldSpace), season->GetID().suffix) : std::make_pair(false, "");
+}
+
 bool SeasonManager::CanSwapLandscape()
 {
+	if (const auto currentState = GetState()) {
+		return currentState->canSwapLandscape;
+	}
+
 	const auto season = GetSeason();
 	return season ? season->CanSwapLandscape() : false;
 }
 
 bool SeasonManager::CanSwapForm(RE::FormType a_formType)
 {
+	if (const auto currentState = GetState()) {
+		return currentState->CanSwapForm(a_formType);
+	}
+
 	const auto season = GetSeason();
 	return season ? season->CanSwapForm(a_formType) : false;
 }
 
 bool SeasonManager::CanSwapGrass()
 {
+	if (const auto currentState = GetState()) {
+		return currentState->CanSwapForm(RE::FormType::Grass);
+	}
+
 	const auto season = GetSeason();
 	return season ? season->CanSwapForm(RE::FormType::Grass) : false;
 }
 
+const SEASON_DELTA& SeasonManager::GetSeasonDelta(SEASON a_oldSeason, SEASON a_newSeason) const
+{
+	return seasonDeltas[stl::to_underlying(a_oldSeason)][stl::to_underlying(a_newSeason)];
+}
+
+bool SeasonManager::RequiresCellReload(SEASON a_oldSeason, SEASON a_newSeason) const
+{
+	//landscape and grass are only generated when a cell is loaded
+	return !GetSeasonDelta(a_oldSeason, a_newSeason).landTextures.empty();
+}
+
+void SeasonManager::GetMemoryUsage(std::vector<memory::TableStats>& a_stats)
+{
+	ForEachSeason([&](Season& a_season) {
+		a_season.GetFormSwapMap().GetMemoryUsage(a_season.GetID().type, a_stats);
+	});
+
+	memory::TableStats bases{ "season deltas (bases)" };
+	memory::TableStats landTextures{ "season deltas (land textures)" };
+	for (const auto& deltas : seasonDeltas) {
+		for (const auto& delta : deltas) {
+			memory::accumulate(bases, memory::get_table_stats({}, delta.bases));
+			memory::accumulate(landTextures, memory::get_table_stats({}, delta.landTextures));
+		}
+	}
+	a_stats.push_back(std::move(bases));
+	a_stats.push_back(std::move(landTextures));
+
+	a_stats.push_back(memory::get_table_stats("land texture slots", landTextureSlots));
+	a_stats.push_back(memory::get_table_stats("texture set slots", textureSetSlots));
+
+	memory::TableStats tables{ "land texture tables" };
+	for (const auto& table : landTextureTables) {
+		memory::accumulate(tables, memory::get_vector_stats({}, table));
+	}
+	a_stats.push_back(std::move(tables));
+}
+
 RE::TESBoundObject* SeasonManager::GetSwapForm(const RE::TESForm* a_form)
 {
-	const auto season = GetSeason();
+	const auto currentState = GetState();
+	const auto season = currentState ? currentState->season : GetSeason();
+	const auto swapForm = season ? season->GetFormSwapMap().GetSwapForm(a_form) : nullptr;
+
+	PROFILE_LOOKUP(Profiler::LOOKUP::kFormSwap, swapForm != nullptr);
+	return swapForm;
+}
+
+RE::TESBoundObject* SeasonManager::GetSwapForm(SEASON a_season, const RE::TESForm* a_form)
+{
+	const auto season = GetSeasonImpl(a_season);
 	return season ? season->GetFormSwapMap().GetSwapForm(a_form) : nullptr;
 }
 
 RE::TESLandTexture* SeasonManager::GetSwapLandTexture(const RE::TESLandTexture* a_landTxst)
 {
-	const auto season = GetSeason();
+	const auto currentState = GetState();
+	const auto season = currentState ? currentState->season : GetSeason();
+	const auto swapLT = season ? season->GetFormSwapMap().GetSwapLandTexture(a_landTxst) : nullptr;
+
+	PROFILE_LOOKUP(Profiler::LOOKUP::kLandTexture, swapLT != nullptr);
+	return swapLT;
+}
+
+RE::TESLandTexture* SeasonManager::GetSwapLandTexture(SEASON a_season, const RE::TESLandTexture* a_landTxst)
+{
+	const auto season = GetSeasonImpl(a_season);
 	return season ? season->GetFormSwapMap().GetSwapLandTexture(a_landTxst) : nullptr;
 }
 
+const LAND_TEXTURE_DATA* SeasonManager::GetLandTextureData(const RE::TESLandTexture* a_landTexture) const
+{
+	const auto currentState = GetState();
+	if (!currentState || !currentState->landTextures) {
+		return nullptr;
+	}
+
+	const auto it = landTextureSlots.find(a_landTexture->GetFormID());
+	return it != landTextureSlots.end() ? std::addressof(currentState->landTextures[it->second]) : nullptr;
+}
+
+const LAND_TEXTURE_DATA* SeasonManager::GetLandTextureData(const RE::BGSTextureSet* a_txst) const
+{
+	const auto currentState = GetState();
+	if (!currentState || !currentState->landTextures || !a_txst) {
+		return nullptr;
+	}
+
+	if (const auto it = textureSetSlots.find(a_txst->GetFormID()); it != textureSetSlots.end()) {
+		return std::addressof(currentState->landTextures[it->second]);
+	}
+	return defaultLandTextureSlot ? std::addressof(currentState->landTextures[*defaultLandTextureSlot]) : nullptr;
+}
+
 RE::TESLandTexture* SeasonManager::GetSwapLandTexture(const RE::BGSTextureSet* a_txst)
 {
-	const auto season = GetSeason();
-	return season ? season->GetFormSwapMap().GetSwapLandTexture(a_txst) : nullptr;
+	const auto currentState = GetState();
+	const auto season = currentState ? currentState->season : GetSeason();
+	const auto swapLT = season ? season->GetFormSwapMap().GetSwapLandTexture(a_txst) : nullptr;
+
+	PROFILE_LOOKUP(Profiler::LOOKUP::kLandTexture, swapLT != nullptr);
+	return swapLT;
 }
 
 bool SeasonManager::GetExterior()
@@ -524,6 +952,14 @@ SEASON SeasonManager::GetSeasonOverride() const
 void SeasonManager::SetSeasonOverride(SEASON a_season)
 {
 	seasonOverride = a_season;
+
+	//called from papyrus
+	const auto scheduler = Scheduler::Manager::GetSingleton();
+	scheduler->Cancel("publish season state");
+	scheduler->Queue("publish season state", Scheduler::PRIORITY::kHigh, [this](float) {
+		PublishState();
+		return true;
+	});
 }
 
 SeasonManager::EventResult SeasonManager::ProcessEvent(const RE::TESActivateEvent* a_event, RE::BSTEventSource<RE::TESActivateEvent>*)
@@ -540,8 +976,8 @@ SeasonManager::EventResult SeasonManager::ProcessEvent(const RE::TESActivateEven
 		return EventResult::kContinue;
 	}
 
-	if (const auto tes = RE::TES::GetSingleton(); UpdateSeason()) {
-		tes->PurgeBufferedCells();
+	if (const auto transition = Transition::Manager::GetSingleton(); UpdateSeason() || transition->HasDeferredChange()) {
+		transition->OnSeasonChange(a_event->objectActivated.get());
 	}
 
 	return EventResult::kContinue;
@@ -1,4 +1,5 @@
 #include "Seasons.h"
+#include "Trace.h"
 
 void Season::LoadSettings(CSimpleIniA& a_ini, bool a_writeComment)
 {
@@ -25,6 +26,8 @@ void Season::LoadSettings(CSimpleIniA& a_ini, bool a_writeComment)
 	//make sure LOD has been generated! No need to check form swaps
 	const auto check_if_lod_exists = [&](bool& a_swaplod, std::string_view a_lodType, std::string_view a_folderPath) {
 		if (a_swaplod) {
+			const Trace::Zone zone{ "directory scan", "io"sv, std::string(a_folderPath) };
+
 			bool exists = false;
 			if (std::filesystem::exists(a_folderPath)) {
 				for (const auto& entry : std::filesystem::directory_iterator(a_folderPath)) {
@@ -58,14 +61,50 @@ bool Season::CanSwapForm(RE::FormType a_formType) const
 	return is_valid_swap_type(a_formType) && is_in_valid_worldspace();
 }
 
+bool Season::CanSwapForm(RE::FormType a_formType, const RE::TESWorldSpace* a_worldSpace) const
+{
+	return is_valid_swap_type(a_formType) && is_in_valid_worldspace(a_worldSpace);
+}
+
+bool Season::IsInValidWorldSpace(const RE::TESWorldSpace* a_worldSpace) const
+{
+	return is_in_valid_worldspace(a_worldSpace);
+}
+
 bool Season::CanSwapLandscape() const
 {
 	return is_in_valid_worldspace();
 }
 
+MapPair<RE::FormID> Season::GetEffectiveSwaps()
+{
+	MapPair<RE::FormID> swaps;
+	formMap.for_each_swap([&](RE::FormID a_base, RE::FormID a_swap) {
+		if (const auto form = RE::TESForm::LookupByID(a_base); form && is_valid_swap_type(form->GetFormType())) {
+			swaps.emplace(a_base, a_swap);
+		}
+	});
+	return swaps;
+}
+
+MapPair<RE::FormID> Season::GetEffectiveLandTextureSwaps()
+{
+	return formMap.get_map("LandTextures"s);
+}
+
+bool Season::GetEffectiveGrassSwap() const
+{
+	return swapGrass;
+}
+
 bool Season::CanSwapLOD(const LOD_TYPE a_type) const
 {
-	if (!is_in_valid_worldspace()) {
+	return CanSwapLOD(a_type, RE::TES::GetSingleton()->worldSpace);
+}
+
+bool Season::CanSwapLOD(const LOD_TYPE a_type, const RE::TESWorldSpace* a_worldSpace) const
+{
+	if (!is_in_valid_worldspace(a_worldSpace)) {
 		return false;
 	}
 
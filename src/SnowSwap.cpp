@@ -1,16 +1,111 @@
 #include "SnowSwap.h"
+#include "NifScanner.h"
+#include "Scheduler.h"
 #include "SeasonManager.h"
+#include "Trace.h"
 
 namespace SnowSwap
 {
+	void Manager::LoadSettings(CSimpleIniA& a_ini)
+	{
+		INI::get_value(a_ini, settings.queueDistantSnow, "Performance", "Queue Distant Snow", ";Apply single pass snow to objects further than the distance below after they load, nearest first.");
+		INI::get_value(a_ini, settings.queueDistance, "Performance", "Snow Queue Distance", nullptr);
+		INI::get_value(a_ini, settings.maxPerFrame, "Performance", "Snow Queue Objects Per Frame", nullptr);
+
+		settings.maxPerFrame = std::max(settings.maxPerFrame, 1u);
+
+		logger::info("queue distant snow : {} (beyond {} units, {} per frame)", settings.queueDistantSnow, settings.queueDistance, settings.maxPerFrame);
+	}
+
+	bool Manager::ShouldQueueSnow(const RE::TESObjectREFR* a_ref) const
+	{
+		if (!settings.queueDistantSnow || !a_ref || !SeasonManager::GetSingleton()->CanApplySnowShader()) {
+			return false;
+		}
+
+		const auto player = RE::PlayerCharacter::GetSingleton();
+		return player && a_ref->GetPosition().GetSquaredDistance(player->GetPosition()) > settings.queueDistance * settings.queueDistance;
+	}
+
+	void Manager::QueueSnow(const RE::TESObjectREFR* a_ref)
+	{
+		Locker locker(_snowQueueLock);
+		_pendingSnow.emplace_back(const_cast<RE::TESObjectREFR*>(a_ref)->CreateRefHandle());
+	}
+
+	void Manager::RegisterSnowQueue()
+	{
+		Scheduler::Manager::GetSingleton()->Queue("snow queue", Scheduler::PRIORITY::kNormal, [this](float a_budget) {
+			ProcessSnowQueue(a_budget);
+			return false;
+		});
+	}
+
+	bool Manager::ProcessSnowQueue(float a_budget)
+	{
+		{
+			Locker locker(_snowQueueLock);
+			for (auto& handle : _pendingSnow) {
+				_snowQueue.push_back({ handle, 0 });
+			}
+			_pendingSnow.clear();
+		}
+
+		if (_snowQueue.empty()) {
+			return true;
+		}
+
+		const auto player = RE::PlayerCharacter::GetSingleton();
+		const auto playerPos = player->GetPosition();
+
+		//drop stale entries, then bring the nearest ones to the front
+		std::vector<std::pair<float, QueuedSnow>> entries;
+		entries.reserve(_snowQueue.size());
+		for (auto& entry : _snowQueue) {
+			const auto ref = entry.handle.get();
+			if (!ref || ref->IsDisabled() || ref->IsDeleted() || entry.frames > 300) {
+				continue;
+			}
+			entries.emplace_back(ref->GetPosition().GetSquaredDistance(playerPos), entry);
+		}
+
+		const auto count = std::min<std::size_t>(settings.maxPerFrame, entries.size());
+		std::ranges::partial_sort(entries, entries.begin() + count, {}, [](const auto& a_entry) { return a_entry.first; });
+
+		const auto start = std::chrono::steady_clock::now();
+		const auto budget = std::chrono::duration<float, std::milli>(a_budget);
+
+		std::size_t processed = 0;
+		for (; processed < count && std::chrono::steady_clock::now() - start < budget; ++processed) {
+			auto& [distance, entry] = entries[processed];
+			const auto ref = entry.handle.get();
+			if (const auto node = ref ? ref->Get3D() : nullptr) {
+				UpdateLoadedSnow(ref.get(), node);
+			} else {
+				entry.frames++;
+				entries.push_back({ distance, entry });  //not attached yet
+			}
+		}
+
+		_snowQueue.clear();
+		for (auto it = entries.begin() + processed; it != entries.end(); ++it) {
+			_snowQueue.push_back(it->second);
+		}
+
+		return _snowQueue.empty();
+	}
+
 	void Manager::LoadSnowShaderSettings()
 	{
 		std::vector<std::string> configs;
 
-		for (constexpr auto folder = R"(Data\Seasons)"; const auto& entry : std::filesystem::directory_iterator(folder)) {
-			if (entry.exists() && !entry.path().empty() && entry.path().extension() == ".ini"sv) {
-				if (const auto path = entry.path().string(); path.contains("_SNOW") || path.contains("_NOSNOW")) {
-					configs.push_back(path);
+		{
+			const Trace::Zone scanZone{ "directory scan", "io"sv, R"(Data\Seasons)" };
+			for (constexpr auto folder = R"(Data\Seasons)"; const auto& entry : std::filesystem::directory_iterator(folder)) {
+				if (entry.exists() && !entry.path().empty() && entry.path().extension() == ".ini"sv) {
+					if (const auto path = entry.path().string(); path.contains("_SNOW") || path.contains("_NOSNOW")) {
+						configs.push_back(path);
+					}
 				}
 			}
 		}
@@ -25,6 +120,8 @@ namespace SnowSwap
 		for (auto& path : configs) {
 			logger::info("	INI : {}", path);
 
+			const Trace::Zone iniZone{ "ini", "io"sv, path };
+
 			CSimpleIniA ini;
 			ini.SetUnicode();
 			ini.SetMultiKey();
@@ -69,6 +166,167 @@ namespace SnowSwap
 		}
 	}
 
+	void Manager::LoadSnowTypeCache()
+	{
+		CSimpleIniA ini;
+		ini.SetUnicode();
+
+		if (const auto rc = ini.LoadFile(snowTypeCache); rc < 0) {
+			return;
+		}
+
+		if (static_cast<std::uint32_t>(ini.GetLongValue("General", "Version", 0)) != snowTypeCacheVersion) {
+			logger::info("Snow type cache is outdated, discarding it");
+			return;
+		}
+
+		CSimpleIniA::TNamesDepend values;
+		ini.GetAllKeys("SnowTypes", values);
+
+		Locker locker(_snowTypeCacheLock);
+
+		for (const auto& key : values) {
+			if (const auto data = string::split(ini.GetValue("SnowTypes", key.pItem, ""), "|"); data.size() == 2) {
+				const auto fingerprint = string::lexical_cast<std::uint64_t>(data[0]);
+				const auto snowType = string::lexical_cast<SNOW_TYPE>(data[1]);
+				_snowTypeCache.emplace(key.pItem, ModelSnowInfo{ fingerprint, snowType, false });
+			}
+		}
+
+		logger::info("Snow type cache : loaded {} models", _snowTypeCache.size());
+	}
+
+	void Manager::SaveSnowTypeCache()
+	{
+		ModelSnowInfoMap cache;
+		{
+			Locker locker(_snowTypeCacheLock);
+			if (!_snowTypeCacheDirty) {
+				return;
+			}
+			cache = _snowTypeCache;
+			_snowTypeCacheDirty = false;
+		}
+
+		CSimpleIniA ini;
+		ini.SetUnicode();
+
+		ini.SetLongValue("General", "Version", snowTypeCacheVersion, ";Snow types are regenerated when the model changes on disk. Delete this file to force a full rebuild.");
+		for (const auto& [path, info] : cache) {
+			const auto value = fmt::format("{}|{}", info.fingerprint, stl::to_underlying(info.snowType));
+			ini.SetValue("SnowTypes", path.c_str(), value.c_str());
+		}
+
+		(void)ini.SaveFile(snowTypeCache);
+	}
+
+	void Manager::PrecomputeSnowTypes(std::function<void()> a_onFinished)
+	{
+		std::vector<std::string> paths;
+		{
+			Set<std::string> uniquePaths;
+			for (const auto& stat : RE::TESDataHandler::GetSingleton()->GetFormArray<RE::TESObjectSTAT>()) {
+				if (!stat || !IsValidSnowBase(stat) || GetWhitelistedForMultiPassSnow(stat)) {
+					continue;
+				}
+				if (auto path = model::normalize_model_path(stat->GetModel()); !path.empty()) {
+					uniquePaths.emplace(std::move(path));
+				}
+			}
+			paths.assign(uniquePaths.begin(), uniquePaths.end());
+		}
+
+		ClassifySnowTypes(std::move(paths), std::move(a_onFinished));
+	}
+
+	void Manager::PrecomputeSnowTypes(const Set<RE::FormID>& a_statics)
+	{
+		std::vector<std::string> paths;
+		{
+			Set<std::string> uniquePaths;
+			for (const auto& formID : a_statics) {
+				const auto stat = RE::TESForm::LookupByID<RE::TESObjectSTAT>(formID);
+				if (!stat || !IsValidSnowBase(stat) || GetWhitelistedForMultiPassSnow(stat)) {
+					continue;
+				}
+				if (auto path = model::normalize_model_path(stat->GetModel()); !path.empty()) {
+					uniquePaths.emplace(std::move(path));
+				}
+			}
+			paths.assign(uniquePaths.begin(), uniquePaths.end());
+		}
+
+		if (!paths.empty()) {
+			ClassifySnowTypes(std::move(paths));
+		}
+	}
+
+	void Manager::ClassifySnowTypes(std::vector<std::string> a_paths, std::function<void()> a_onFinished)
+	{
+		logger::info("Snow type cache : classifying {} models in background", a_paths.size());
+
+		_classifier.Queue([this, paths = std::move(a_paths), onFinished = std::move(a_onFinished)]() {
+			{
+				const Trace::Zone zone{ "ClassifySnowTypes", "startup"sv, fmt::format("{} models", paths.size()) };
+
+				const auto start = std::chrono::steady_clock::now();
+
+				std::size_t cached = 0;
+				std::size_t scanned = 0;
+				std::size_t unknown = 0;
+				std::size_t bytes = 0;
+
+				for (const auto& path : paths) {
+					{
+						//already checked this session, skip reading the file again
+						ReadLocker locker(_snowTypeCacheLock);
+						if (const auto it = _snowTypeCache.find(path); it != _snowTypeCache.end() && it->second.validated) {
+							++cached;
+							continue;
+						}
+					}
+
+					const auto fingerprint = model::get_fingerprint(path);
+					{
+						Locker locker(_snowTypeCacheLock);
+						if (const auto it = _snowTypeCache.find(path); it != _snowTypeCache.end() && it->second.fingerprint == fingerprint) {
+							it->second.validated = true;
+							++cached;
+							continue;
+						}
+					}
+
+					auto result = NifScanner::RESULT::kUnknown;
+					if (const std::filesystem::path loosePath{ fmt::format(R"(Data\Meshes\{})", path) }; std::filesystem::exists(loosePath)) {
+						const NifScanner::MappedFile file{ loosePath };
+						result = file.is_open() ? NifScanner::Scan(file.data()) : result;
+						bytes += file.data().size();
+					} else {
+						const auto buffer = model::read_archived_model(path);
+						result = NifScanner::Scan(buffer);
+						bytes += buffer.size();
+					}
+
+					if (result == NifScanner::RESULT::kUnknown) {
+						++unknown;  //classified from 3D on first clone
+						continue;
+					}
+
+					CacheSnowType(path, fingerprint, result == NifScanner::RESULT::kMultiPass ? SNOW_TYPE::kMultiPass : SNOW_TYPE::kSinglePass);
+					++scanned;
+				}
+
+				const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+				logger::info("Snow type cache : {} cached, {} scanned, {} deferred to 3D ({:.2f} MB in {:.0f} ms)", cached, scanned, unknown, bytes / (1024.0 * 1024.0), elapsed);
+			}
+
+			//after the zone above is recorded
+			if (onFinished) {
+				onFinished();
+			}
+		});
+	}
+
 	bool Manager::GetBlacklisted(const RE::TESForm* a_form) const
 	{
 		return _snowShaderBlacklist.contains(a_form->GetFormID());
@@ -97,6 +355,19 @@ namespace SnowSwap
 		return it != _multipassSnowWhitelist.end();
 	}
 
+	bool Manager::IsValidSnowBase(const RE::TESObjectSTAT* a_static) const
+	{
+		if (a_static->IsMarker() || a_static->IsHeadingMarker() || GetBaseBlacklisted(a_static)) {
+			return false;
+		}
+
+		if (const auto matObject = a_static->data.materialObj; matObject && (util::is_snow_shader(matObject) || util::get_editorID(matObject).contains("Ice"sv))) {
+			return false;
+		}
+
+		return !a_static->IsSnowObject() && !a_static->IsSkyObject() && !a_static->HasTreeLOD();
+	}
+
 	SWAP_RESULT Manager::CanApplySnowShader(RE::TESObjectREFR* a_ref) const
 	{
 		if (!SeasonManager::GetSingleton()->CanApplySnowShader()) {
@@ -130,28 +401,57 @@ namespace SnowSwap
 			return SWAP_RESULT::kRefFail;
 		}
 
-		const auto base = util::get_original_base(a_ref);
-
-		if (base != a_static || a_static->IsMarker() || a_static->IsHeadingMarker() || GetBaseBlacklisted(a_static)) {
+		if (const auto base = util::get_original_base(a_ref); base != a_static || !IsValidSnowBase(a_static)) {
 			return SWAP_RESULT::kBaseFail;
 		}
 
-		if (const auto matObject = a_static->data.materialObj; matObject && (util::is_snow_shader(matObject) || util::get_editorID(matObject).contains("Ice"sv))) {
-			return SWAP_RESULT::kBaseFail;
+		if (raycast::is_under_shelter(a_ref)) {
+			return SWAP_RESULT::kRefFail;
 		}
 
-		if (a_static->IsSnowObject() || a_static->IsSkyObject() || a_static->HasTreeLOD()) {
-			return SWAP_RESULT::kBaseFail;
+		return SWAP_RESULT::kSuccess;
+	}
+
+	std::optional<SNOW_TYPE> Manager::GetSnowType(const RE::TESObjectSTAT* a_static)
+	{
+		if (GetWhitelistedForMultiPassSnow(a_static)) {
+			return SNOW_TYPE::kMultiPass;
 		}
 
-		if (raycast::is_under_shelter(a_ref)) {
-			return SWAP_RESULT::kRefFail;
+		const auto path = model::normalize_model_path(a_static->GetModel());
+
+		std::optional<ModelSnowInfo> info;
+		{
+			Locker locker(_snowTypeCacheLock);
+			if (const auto it = _snowTypeCache.find(path); it != _snowTypeCache.end()) {
+				info = it->second;
+			}
 		}
 
-		return SWAP_RESULT::kSuccess;
+		if (!info) {
+			return std::nullopt;
+		}
+
+		if (info->validated) {
+			return info->snowType;
+		}
+
+		//first lookup this session, make sure the model hasn't changed
+		const auto fingerprint = model::get_fingerprint(path);
+
+		Locker locker(_snowTypeCacheLock);
+		if (fingerprint != info->fingerprint) {
+			_snowTypeCache.erase(path);
+			_snowTypeCacheDirty = true;
+			return std::nullopt;
+		}
+		if (const auto it = _snowTypeCache.find(path); it != _snowTypeCache.end()) {
+			it->second.validated = true;
+		}
+		return info->snowType;
 	}
 
-	SNOW_TYPE Manager::GetSnowType(const RE::TESObjectSTAT* a_static, RE::NiAVObject* a_node) const
+	SNOW_TYPE Manager::GetSnowType(const RE::TESObjectSTAT* a_static, RE::NiAVObject* a_node)
 	{
 		using Flag = RE::BSShaderProperty::EShaderPropertyFlag;
 
@@ -207,19 +507,62 @@ namespace SnowSwap
 			return RE::BSVisit::BSVisitControl::kContinue;
 		});
 
-		if (hasShape && !hasInvalidShape && hasLightingShaderProp && !hasAlphaProp) {
-			return SNOW_TYPE::kMultiPass;
+		const auto snowType = hasShape && !hasInvalidShape && hasLightingShaderProp && !hasAlphaProp ?
+		                          SNOW_TYPE::kMultiPass :
+		                          SNOW_TYPE::kSinglePass;
+
+		if (auto path = model::normalize_model_path(a_static->GetModel()); !path.empty()) {
+			const auto fingerprint = model::get_fingerprint(path);
+			CacheSnowType(std::move(path), fingerprint, snowType);
 		}
 
-		return SNOW_TYPE::kSinglePass;
+		return snowType;
 	}
 
-	void Manager::ApplySinglePassSnow(RE::NiAVObject* a_node, float a_angle)
+	void Manager::CacheSnowType(std::string a_path, std::uint64_t a_fingerprint, SNOW_TYPE a_snowType)
+	{
+		Locker locker(_snowTypeCacheLock);
+
+		_snowTypeCache.insert_or_assign(std::move(a_path), ModelSnowInfo{ a_fingerprint, a_snowType, true });
+		_snowTypeCacheDirty = true;
+	}
+
+	RE::NiBooleanExtraData* Manager::GetSnowShaderData()
+	{
+		std::call_once(_snowShaderDataInit, [this]() {
+			_snowShaderData.reset(RE::NiBooleanExtraData::Create("SOS_SNOW_SHADER", true));
+		});
+		return _snowShaderData.get();
+	}
+
+	bool Manager::IsSnowedModel(const RE::TESModel* a_model)
+	{
+		ReadLocker locker(_snowedModelsLock);
+
+		return a_model && _snowedModels.contains(a_model->model.c_str());
+	}
+
+	void Manager::SetSnowedModel(const RE::TESModel* a_model)
+	{
+		if (!a_model || IsSnowedModel(a_model)) {
+			return;
+		}
+
+		Locker locker(_snowedModelsLock);
+		_snowedModels.emplace(a_model->model.c_str());
+	}
+
+	void Manager::ApplySinglePassSnow(RE::NiAVObject* a_node, const RE::TESModel* a_model, float a_angle)
 	{
 		if (!a_node) {
 			return;
 		}
 
+		const auto snowShaderData = GetSnowShaderData();
+		if (snowShaderData && a_node->GetExtraData(snowShaderData->name)) {
+			return;
+		}
+
 		auto& [init, defProjectedParams, defProjectedColor] = _defaultObj;
 		if (!init) {
 			const auto snowMat = GetSinglePassSnowShader();
@@ -241,19 +584,26 @@ namespace SnowSwap
 			projectedParams.alpha = std::cosf(RE::deg_to_rad(a_angle));
 		}
 
-		if (a_node->SetProjectedUVData(projectedParams, defProjectedColor, true)) {
-			if (const auto snowShaderData = RE::NiBooleanExtraData::Create("SOS_SNOW_SHADER", true)) {
-				a_node->AddExtraData(snowShaderData);
-			}
+		SetSnowedModel(a_model);
+
+		if (a_node->SetProjectedUVData(projectedParams, defProjectedColor, true) && snowShaderData) {
+			a_node->AddExtraData(snowShaderData);
 		}
 	}
 
-	void Manager::RemoveSinglePassSnow(RE::NiAVObject* a_node) const
+	void Manager::RemoveSinglePassSnow(RE::NiAVObject* a_node, const RE::TESModel* a_model)
 	{
 		if (!a_node) {
 			return;
 		}
 
+		const auto snowShaderData = GetSnowShaderData();
+		const bool hasSnowShaderData = snowShaderData && a_node->GetExtraData(snowShaderData->name);
+
+		if (!hasSnowShaderData && !IsSnowedModel(a_model)) {
+			return;
+		}
+
 		using Flag8 = RE::BSShaderProperty::EShaderPropertyFlag8;
 
 		RE::BSVisit::TraverseScenegraphGeometries(a_node, [&](RE::BSGeometry* a_geometry) -> RE::BSVisit::BSVisitControl {
@@ -267,12 +617,74 @@ namespace SnowSwap
 			return RE::BSVisit::BSVisitControl::kContinue;
 		});
 
-		a_node->RemoveExtraData("SOS_SNOW_SHADER");
+		if (hasSnowShaderData) {
+			a_node->RemoveExtraData(snowShaderData->name);
+		}
+	}
+
+	bool Manager::UpdateLoadedSnow(RE::TESObjectREFR* a_ref, RE::NiAVObject* a_node)
+	{
+		const auto base = a_ref->GetBaseObject();
+		if (!base) {
+			return false;
+		}
+
+		if (const auto stat = base->As<RE::TESObjectSTAT>()) {
+			const auto result = CanApplySnowShader(stat, a_ref);
+			const auto snowInfo = GetSnowInfo(stat);
+
+			if (!snowInfo) {
+				return result == SWAP_RESULT::kSuccess;  //classified when cloned
+			}
+			if (snowInfo->snowType == SNOW_TYPE::kMultiPass) {
+				return result != SWAP_RESULT::kBaseFail;  //material is read when cloned
+			}
+
+			if (result == SWAP_RESULT::kSuccess) {
+				ApplySinglePassSnow(a_node, stat, stat->data.materialThresholdAngle);
+			} else if (result == SWAP_RESULT::kSeasonFail || result == SWAP_RESULT::kRefFail) {
+				RemoveSinglePassSnow(a_node, stat);
+			}
+		} else if (base->Is(RE::FormType::MovableStatic, RE::FormType::Container)) {
+			if (const auto result = CanApplySnowShader(a_ref); result == SWAP_RESULT::kSuccess) {
+				ApplySinglePassSnow(a_node, base->As<RE::TESModel>());
+			} else if (result == SWAP_RESULT::kSeasonFail || result == SWAP_RESULT::kRefFail) {
+				RemoveSinglePassSnow(a_node, base->As<RE::TESModel>());
+			}
+		}
+
+		return false;
+	}
+
+	void Manager::GetMemoryUsage(std::vector<memory::TableStats>& a_stats) const
+	{
+		a_stats.push_back(memory::get_table_stats("snow shader blacklist", _snowShaderBlacklist));
+		a_stats.push_back(memory::get_table_stats("multipass snow whitelist", _multipassSnowWhitelist));
+		{
+			ReadLocker locker(_snowInfoLock);
+			a_stats.push_back(memory::get_table_stats("snow info", _snowInfoMap));
+		}
+		{
+			ReadLocker locker(_multiPassLock);
+			a_stats.push_back(memory::get_vector_stats("multipass statics", _multiPassStatics));
+		}
+		{
+			ReadLocker locker(_snowTypeCacheLock);
+			a_stats.push_back(memory::get_table_stats("snow type cache", _snowTypeCache));
+		}
+		{
+			ReadLocker locker(_snowedModelsLock);
+			a_stats.push_back(memory::get_table_stats("snowed models", _snowedModels));
+		}
+		{
+			ReadLocker locker(_snowQueueLock);
+			a_stats.push_back(memory::get_vector_stats("pending snow", _pendingSnow));
+		}
 	}
 
 	std::optional<Manager::SnowInfo> Manager::GetSnowInfo(const RE::TESObjectSTAT* a_static)
 	{
-		Locker locker(_snowInfoLock);
+		ReadLocker locker(_snowInfoLock);
 
 		if (const auto it = _snowInfoMap.find(a_static->GetFormID()); it != _snowInfoMap.end()) {
 			return it->second;
@@ -280,12 +692,51 @@ namespace SnowSwap
 		return std::nullopt;
 	}
 
-	void Manager::SetSnowInfo(const RE::TESObjectSTAT* a_static, RE::BGSMaterialObject* a_originalMat, SNOW_TYPE a_snowType)
+	Manager::SnowInfo Manager::SetSnowInfo(RE::TESObjectSTAT* a_static, RE::BGSMaterialObject* a_originalMat, SNOW_TYPE a_snowType)
 	{
 		Locker locker(_snowInfoLock);
 
-		SnowInfo snowInfo{ a_originalMat ? a_originalMat->GetFormID() : 0, a_snowType };
-		_snowInfoMap.emplace(a_static->GetFormID(), snowInfo);
+		const auto [it, inserted] = _snowInfoMap.emplace(a_static->GetFormID(), SnowInfo{ a_originalMat, a_snowType });
+		if (inserted && a_snowType == SNOW_TYPE::kMultiPass) {
+			Locker multiPassLocker(_multiPassLock);
+
+			_multiPassStatics.emplace_back(a_static, a_originalMat);
+			if (_multiPassSnowApplied) {
+				a_static->data.materialObj = GetMultiPassSnowShader();
+			}
+		}
+
+		return it->second;
+	}
+
+	void Manager::UpdateMultiPassSnow(bool a_applySnow)
+	{
+		if (_multiPassSnowApplied.load(std::memory_order_acquire) == a_applySnow) {
+			return;
+		}
+
+		Locker locker(_multiPassLock);
+
+		if (_multiPassSnowApplied.load(std::memory_order_relaxed) == a_applySnow) {
+			return;
+		}
+
+		const auto snowShader = GetMultiPassSnowShader();
+		for (const auto& [stat, origShader] : _multiPassStatics) {
+			stat->data.materialObj = a_applySnow ? snowShader : origShader;
+		}
+
+		_multiPassSnowApplied.store(a_applySnow, std::memory_order_release);
+	}
+
+	void Manager::UpdateMultiPassSnow()
+	{
+		UpdateMultiPassSnow(SeasonManager::GetSingleton()->CanApplySnowShader());
+	}
+
+	bool Manager::IsMultiPassSnowApplied() const
+	{
+		return _multiPassSnowApplied.load(std::memory_order_acquire);
 	}
 
 	RE::BGSMaterialObject* Manager::GetMultiPassSnowShader()
@@ -0,0 +1,143 @@
+#include "SwapMemo.h"
+
+namespace SwapMemo
+{
+	std::optional<Decision> Manager::Find(RE::FormID a_ref, std::uint32_t a_epoch) const
+	{
+		const auto& shard = _shards[GetShardIndex(a_ref)];
+
+		ReadLocker locker(shard.lock);
+		if (const auto it = shard.entries.find(a_ref); it != shard.entries.end() && it->second.epoch == a_epoch) {
+			return it->second.decision;
+		}
+		return std::nullopt;
+	}
+
+	void Manager::Record(RE::FormID a_ref, const Decision& a_decision, std::uint32_t a_epoch)
+	{
+		auto& shard = _shards[GetShardIndex(a_ref)];
+
+		Locker locker(shard.lock);
+		shard.entries.insert_or_assign(a_ref, Entry{ a_epoch, a_decision });
+	}
+
+	void Manager::Record(const Decisions& a_decisions, std::uint32_t a_epoch)
+	{
+		std::array<std::vector<const std::pair<RE::FormID, Decision>*>, numShards> byShard{};
+		for (const auto& decision : a_decisions) {
+			byShard[GetShardIndex(decision.first)].push_back(&decision);
+		}
+
+		for (std::size_t i = 0; i < numShards; ++i) {
+			if (byShard[i].empty()) {
+				continue;
+			}
+
+			auto& shard = _shards[i];
+
+			Locker locker(shard.lock);
+			for (const auto& pair : byShard[i]) {
+				shard.entries.insert_or_assign(pair->first, Entry{ a_epoch, pair->second });
+			}
+		}
+	}
+
+	void Manager::CountLookup(RE::FormID a_ref, bool a_hit)
+	{
+		auto& shard = _shards[GetShardIndex(a_ref)];
+		(a_hit ? shard.hits : shard.misses).fetch_add(1, std::memory_order_relaxed);
+	}
+
+	bool Manager::BeginCell(RE::FormID a_cell, std::uint32_t a_epoch)
+	{
+		{
+			ReadLocker locker(_cellLock);
+			if (const auto it = _cells.find(a_cell); it != _cells.end() && it->second == a_epoch) {
+				return false;
+			}
+		}
+
+		Locker locker(_cellLock);
+		auto& epoch = _cells[a_cell];
+		if (epoch == a_epoch) {
+			return false;  //another thread got there first
+		}
+		epoch = a_epoch;
+		return true;
+	}
+
+	void Manager::CountCell(std::size_t a_refs, std::size_t a_uniqueBases)
+	{
+		_batchedCells.fetch_add(1, std::memory_order_relaxed);
+		_batchedRefs.fetch_add(a_refs, std::memory_order_relaxed);
+		_batchedBases.fetch_add(a_uniqueBases, std::memory_order_relaxed);
+	}
+
+	void Manager::OnEpochChange(std::uint32_t a_epoch)
+	{
+		std::uint64_t hits = 0;
+		std::uint64_t misses = 0;
+		std::size_t entries = 0;
+
+		//late records from hooks still on the old state carry its epoch. If that state is published again they still hold,
+		//a decision only depends on the state contents and the base the reference had
+		for (auto& shard : _shards) {
+			Locker locker(shard.lock);
+			entries += shard.entries.size();
+			shard.entries.clear();
+
+			hits += shard.hits.exchange(0, std::memory_order_relaxed);
+			misses += shard.misses.exchange(0, std::memory_order_relaxed);
+		}
+
+		{
+			Locker locker(_cellLock);
+			_cells.clear();
+		}
+
+		_totalHits += hits;
+		_totalMisses += misses;
+
+		if (hits + misses > 0) {
+			logger::info("Swap memo : epoch {} -> {}, {} refs, {} hits, {} misses ({:.1f}% hit rate)", _epoch, a_epoch, entries, hits, misses, 100.0 * static_cast<double>(hits) / static_cast<double>(hits + misses));
+		}
+
+		_epoch = a_epoch;
+	}
+
+	void Manager::LogStatistics() const
+	{
+		auto hits = _totalHits;
+		auto misses = _totalMisses;
+		std::size_t entries = 0;
+
+		for (auto& shard : _shards) {
+			ReadLocker locker(shard.lock);
+			entries += shard.entries.size();
+
+			hits += shard.hits.load(std::memory_order_relaxed);
+			misses += shard.misses.load(std::memory_order_relaxed);
+		}
+
+		const auto total = hits + misses;
+		logger::info("Swap memo : epoch {}, {} refs, {} hits, {} misses ({:.1f}% hit rate)", _epoch, entries, hits, misses, total ? 100.0 * static_cast<double>(hits) / static_cast<double>(total) : 0.0);
+
+		const auto cells = _batchedCells.load(std::memory_order_relaxed);
+		const auto refs = _batchedRefs.load(std::memory_order_relaxed);
+		const auto bases = _batchedBases.load(std::memory_order_relaxed);
+		logger::info("Swap memo : {} cells batched, {} refs resolved from {} unique bases ({:.1f} refs per base)", cells, refs, bases, bases ? static_cast<double>(refs) / static_cast<double>(bases) : 0.0);
+	}
+
+	void Manager::GetMemoryUsage(std::vector<memory::TableStats>& a_stats) const
+	{
+		memory::TableStats stats{ "swap memo" };
+		for (auto& shard : _shards) {
+			ReadLocker locker(shard.lock);
+			memory::accumulate(stats, memory::get_table_stats({}, shard.entries));
+		}
+		a_stats.push_back(std::move(stats));
+
+		ReadLocker locker(_cellLock);
+		a_stats.push_back(memory::get_table_stats("swap memo (batched cells)", _cells));
+	}
+}
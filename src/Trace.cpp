@@ -0,0 +1,138 @@
+#include "Trace.h"
+
+namespace Trace
+{
+	namespace detail
+	{
+		struct Event
+		{
+			std::string name;
+			std::string_view category;
+			std::string args;
+			std::uint32_t threadID;
+			std::int64_t start;     //us
+			std::int64_t duration;  //us
+		};
+
+		struct Recorder
+		{
+			std::mutex lock;
+			std::vector<Event> events;
+			std::atomic_bool enabled{ false };
+			std::chrono::steady_clock::time_point epoch{ std::chrono::steady_clock::now() };
+		};
+
+		Recorder& get_recorder()
+		{
+			static Recorder recorder;
+			return recorder;
+		}
+
+		std::string escape(std::string_view a_str)
+		{
+			std::string result;
+			result.reserve(a_str.size());
+			for (const auto c : a_str) {
+				switch (c) {
+				case '"':
+					result += R"(\")";
+					break;
+				case '\\':
+					result += R"(\\)";
+					break;
+				default:
+					if (static_cast<unsigned char>(c) >= 0x20) {
+						result += c;
+					}
+					break;
+				}
+			}
+			return result;
+		}
+	}
+
+	Zone::Zone(std::string a_name, std::string_view a_category, std::string a_args) :
+		name(std::move(a_name)),
+		category(a_category),
+		args(std::move(a_args)),
+		start(std::chrono::steady_clock::now()),
+		active(detail::get_recorder().enabled)
+	{}
+
+	Zone::~Zone()
+	{
+		if (!active) {
+			return;
+		}
+
+		const auto end = std::chrono::steady_clock::now();
+
+		auto& recorder = detail::get_recorder();
+
+		using us = std::chrono::microseconds;
+		detail::Event event{
+			std::move(name),
+			category,
+			std::move(args),
+			static_cast<std::uint32_t>(GetCurrentThreadId()),
+			std::chrono::duration_cast<us>(start - recorder.epoch).count(),
+			std::chrono::duration_cast<us>(end - start).count()
+		};
+
+		std::scoped_lock locker(recorder.lock);
+		if (recorder.enabled) {
+			recorder.events.push_back(std::move(event));
+		}
+	}
+
+	void Enable()
+	{
+		auto& recorder = detail::get_recorder();
+
+		std::scoped_lock locker(recorder.lock);
+		recorder.enabled = true;
+	}
+
+	void Write()
+	{
+		auto& recorder = detail::get_recorder();
+
+		std::vector<detail::Event> events;
+		{
+			std::scoped_lock locker(recorder.lock);
+			if (!recorder.enabled.exchange(false)) {
+				return;
+			}
+			events.swap(recorder.events);
+		}
+
+		auto path = logger::log_directory();
+		if (!path) {
+			return;
+		}
+		*path /= fmt::format("{}_trace.json", Version::PROJECT);
+
+		std::ofstream file{ *path };
+		if (!file) {
+			logger::warn("Couldn't write startup trace to {}", path->string());
+			return;
+		}
+
+		const auto pid = GetCurrentProcessId();
+
+		file << R"({"displayTimeUnit":"ms","traceEvents":[)";
+		for (std::size_t i = 0; i < events.size(); ++i) {
+			const auto& [name, category, args, threadID, start, duration] = events[i];
+
+			file << fmt::format(R"({}{{"name":"{}","cat":"{}","ph":"X","pid":{},"tid":{},"ts":{},"dur":{})",
+				i ? ",\n" : "\n", detail::escape(name), category, pid, threadID, start, duration);
+			if (!args.empty()) {
+				file << fmt::format(R"(,"args":{{"detail":"{}"}})", detail::escape(args));
+			}
+			file << "}";
+		}
+		file << "\n]}\n";
+
+		logger::info("Wrote startup trace ({} zones) to {}", events.size(), path->string());
+	}
+}
@@ -0,0 +1,222 @@
+#include "Transition.h"
+#include "CellIndex.h"
+#include "FormSwap.h"
+#include "Prefetch.h"
+#include "Scheduler.h"
+#include "SeasonManager.h"
+#include "SnowSwap.h"
+
+namespace Transition
+{
+	void Manager::LoadSettings(CSimpleIniA& a_ini)
+	{
+		INI::get_value(a_ini, settings.enabled, "Performance", "Incremental Transition", ";Refresh loaded references over several frames when the season changes, instead of reloading all buffered cells.\n;Cells are still reloaded when changing worldspaces or when land textures are swapped.");
+		INI::get_value(a_ini, settings.budget, "Performance", "Transition Budget", ";Time spent per frame on refreshing references, in milliseconds.");
+
+		if (settings.budget <= 0.0f) {
+			settings.budget = 2.0f;
+		}
+
+		logger::info("incremental transition : {} ({} ms/frame)", settings.enabled, settings.budget);
+	}
+
+	std::pair<RE::TESWorldSpace*, RE::NiPoint3> Manager::GetDestination(const RE::TESObjectREFR* a_door)
+	{
+		if (const auto teleport = a_door ? a_door->extraList.GetByType<RE::ExtraTeleport>() : nullptr; teleport && teleport->teleportData) {
+			if (const auto linkedDoor = teleport->teleportData->linkedDoor.get()) {
+				return { linkedDoor->GetWorldspace(), teleport->teleportData->position };
+			}
+		}
+		return { nullptr, RE::NiPoint3() };
+	}
+
+	bool Manager::HasDeferredChange() const
+	{
+		return deferred;
+	}
+
+	void Manager::OnSeasonChange(const RE::TESObjectREFR* a_door)
+	{
+		const auto [destination, destinationPos] = GetDestination(a_door);
+
+		//interior to interior, buffered exterior cells are dealt with once the player heads outside
+		if (!destination) {
+			if (deferred) {
+				mergedChanges++;
+			}
+			deferred = true;
+			return;
+		}
+		if (std::exchange(deferred, false)) {
+			mergedChanges++;
+		}
+
+		const auto seasonManager = SeasonManager::GetSingleton();
+		const auto cellIndex = CellIndex::Manager::GetSingleton();
+
+		const auto newSeason = seasonManager->GetCurrentSeasonType();
+		if (newSeason == lastSeason && lastWorldSpace) {
+			pending = false;
+			logger::info("Season transition : back to the season of the buffered cells, nothing to do ({} merged so far)", ++mergedChanges);
+			return;
+		}
+
+		const auto& delta = seasonManager->GetSeasonDelta(lastSeason, newSeason);
+		const bool cellReload = seasonManager->RequiresCellReload(lastSeason, newSeason);
+
+		//read what the destination needs while the loading screen is up
+		Prefetch::Manager::GetSingleton()->PrefetchDestination(lastSeason, newSeason, destination, destinationPos);
+
+		if (!cellReload && settings.enabled && lastWorldSpace && destination == lastWorldSpace) {
+			pending = true;
+			return;
+		}
+
+		pending = false;
+		queue.clear();
+		queueIdx = 0;
+
+		//nothing buffered would look different in the new season
+		if (!cellReload && !cellIndex->HasAffectedBufferedCells(delta, (lastSeason == SEASON::kWinter) != (newSeason == SEASON::kWinter))) {
+			logger::info("Season transition : no buffered cell is affected, skipping purge");
+			return;
+		}
+
+		if (const auto tes = RE::TES::GetSingleton()) {
+			tes->PurgeBufferedCells();
+		}
+		cellIndex->ClearBufferedCells();
+
+		logger::info("Season transition : purged buffered cells");
+		cellIndex->LogStatistics();
+	}
+
+	void Manager::Start()
+	{
+		const auto seasonManager = SeasonManager::GetSingleton();
+		const auto& delta = seasonManager->GetSeasonDelta(lastSeason, seasonManager->GetSeasonType());
+
+		snowChanged = seasonManager->CanApplySnowShader() != lastSnowState;
+
+		queue.clear();
+		queueIdx = 0;
+		refreshed = 0;
+		reloaded = 0;
+		startTime = std::chrono::steady_clock::now();
+
+		const auto cellIndex = CellIndex::Manager::GetSingleton();
+
+		const auto tes = RE::TES::GetSingleton();
+		const auto gridCells = tes->gridCells;
+		const auto gridLength = gridCells ? gridCells->length : 0;
+
+		Set<RE::FormID> gridCellIDs;
+
+		for (std::uint32_t x = 0; x < gridLength; ++x) {
+			for (std::uint32_t y = 0; y < gridLength; ++y) {
+				const auto cell = gridCells->GetCell(x, y);
+				if (cell) {
+					gridCellIDs.insert(cell->GetFormID());
+				}
+				if (!cell || !cell->IsAttached() || !cellIndex->IsAffected(cell, delta, snowChanged)) {
+					continue;
+				}
+				cell->ForEachReference([&](RE::TESObjectREFR& a_ref) {
+					const auto base = a_ref.IsPlayerRef() ? nullptr : util::get_original_base(&a_ref);
+					if (base && (delta.bases.contains(base->GetFormID()) || snowChanged && cellIndex->IsSnowBase(base->GetFormID()))) {
+						queue.emplace_back(a_ref.CreateRefHandle());
+					}
+					return RE::BSContainer::ForEachResult::kContinue;
+				});
+			}
+		}
+
+		//only the grid is refreshed above. Buffered cells outside it would reattach with the old season's 3D when walked back into
+		if (cellIndex->HasAffectedBufferedCells(delta, snowChanged, gridCellIDs)) {
+			tes->PurgeBufferedCells();
+			cellIndex->ClearBufferedCells(gridCellIDs);
+
+			logger::info("Season transition : purged buffered cells outside the loaded grid");
+		}
+	}
+
+	bool Manager::Process(float a_budget)
+	{
+		const auto snowManager = SnowSwap::Manager::GetSingleton();
+
+		const auto budget = std::chrono::duration<float, std::milli>(std::min(a_budget, settings.budget));
+		const auto start = std::chrono::steady_clock::now();
+
+		while (queueIdx < queue.size()) {
+			if (const auto ref = queue[queueIdx++].get()) {
+				const auto root = ref->Get3D();
+
+				auto reload = FormSwap::detail::update_base(ref.get());
+				if (!reload && root && snowChanged) {
+					reload = snowManager->UpdateLoadedSnow(ref.get(), root);
+				}
+
+				if (reload && root) {
+					//drop the old 3D and queue the reference in the model loader again, which picks up the new base and snow state.
+					//the enabled flag is left alone, so nothing is written to the save and no enable/disable events fire
+					if (const auto parent = root->parent) {
+						parent->DetachChild2(root);
+					}
+					ref->Set3D(nullptr, false);
+					ref->Load3D(true);
+					reloaded++;
+				} else {
+					refreshed++;
+				}
+			}
+
+			if (std::chrono::steady_clock::now() - start >= budget) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void Manager::Register()
+	{
+		Scheduler::Manager::GetSingleton()->Queue("season transition", Scheduler::PRIORITY::kHigh, [this](float a_budget) {
+			Update(a_budget);
+			return false;
+		});
+	}
+
+	void Manager::Update(float a_budget)
+	{
+		const auto seasonManager = SeasonManager::GetSingleton();
+		if (!seasonManager->GetExterior()) {
+			return;
+		}
+
+		const auto tes = RE::TES::GetSingleton();
+		const auto worldSpace = tes ? tes->worldSpace : nullptr;
+		if (!worldSpace) {
+			return;
+		}
+
+		if (pending) {
+			pending = false;
+			Start();
+		}
+
+		if (queueIdx < queue.size()) {
+			if (Process(a_budget)) {
+				const auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime);
+				logger::info("Season transition : {} references refreshed, {} reloaded ({:.2f} ms)", refreshed, reloaded, elapsed.count());
+
+				queue.clear();
+				queueIdx = 0;
+			}
+			return;
+		}
+
+		lastWorldSpace = worldSpace;
+		lastSeason = seasonManager->GetSeasonType();
+		lastSnowState = seasonManager->CanApplySnowShader();
+	}
+}
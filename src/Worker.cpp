@@ -0,0 +1,48 @@
+#include "Worker.h"
+
+Worker::~Worker()
+{
+	if (_thread.joinable()) {
+		_thread.request_stop();
+		_wake.notify_all();
+	}
+}
+
+void Worker::Queue(Job a_job)
+{
+	{
+		Locker locker(_lock);
+		_jobs.push_back(std::move(a_job));
+		if (!_thread.joinable()) {
+			_thread = std::jthread([this](std::stop_token a_stop) { Run(a_stop); });
+		}
+	}
+	_wake.notify_one();
+}
+
+std::size_t Worker::GetPending() const
+{
+	Locker locker(_lock);
+	return _jobs.size();
+}
+
+void Worker::Run(std::stop_token a_stop)
+{
+	while (true) {
+		Job job;
+		{
+			Locker locker(_lock);
+			if (!_wake.wait(locker, a_stop, [this] { return !_jobs.empty(); })) {
+				return;  //stop requested
+			}
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+		}
+
+		try {
+			job();
+		} catch (const std::exception& e) {
+			logger::error("{} worker : job failed ({})", _name, e.what());
+		}
+	}
+}
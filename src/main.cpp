@@ -1,10 +1,16 @@
+#include "CellIndex.h"
 #include "FormSwap.h"
 #include "LODSwap.h"
 #include "LandscapeSwap.h"
 #include "MergeMapperPluginAPI.h"
 #include "Papyrus.h"
+#include "Prefetch.h"
+#include "Profiler.h"
+#include "Scheduler.h"
 #include "SeasonManager.h"
 #include "SnowSwap.h"
+#include "Trace.h"
+#include "Transition.h"
 
 void MessageHandler(SKSE::MessagingInterface::Message* a_message)
 {
@@ -13,12 +19,15 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_message)
 	switch (a_message->type) {
 	case SKSE::MessagingInterface::kPostLoad:
 		{
+			const Trace::Zone zone{ "kPostLoad" };
+
 			logger::info("{:*^30}", "DEPENDENCIES");
 
 			tweaks = GetModuleHandle(L"po3_Tweaks");
 			logger::info("powerofthree's Tweaks (po3_tweaks) detected : {}", tweaks != nullptr);
 
 			try {
+				const Trace::Zone settingsZone{ "LoadSettings" };
 				SeasonManager::GetSingleton()->LoadSettings();
 			} catch (...) {
 				logger::error("Exception caught when loading settings! Check whether your setting values are valid. Default values will be used instead");
@@ -26,12 +35,19 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_message)
 
 			logger::info("{:*^30}", "HOOKS");
 
+			const Trace::Zone hooksZone{ "InstallHooks" };
+
 			SeasonManager::InstallHooks();
 
 			FormSwap::Install();
 			LandscapeSwap::Install();
 			LODSwap::Install();
 			SnowSwap::Install();
+			Scheduler::Install();
+
+			Transition::Manager::GetSingleton()->Register();
+			Prefetch::Manager::GetSingleton()->Register();
+			SnowSwap::Manager::GetSingleton()->RegisterSnowQueue();
 		}
 		break;
 	case SKSE::MessagingInterface::kPostPostLoad:
@@ -48,6 +64,8 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_message)
 		break;
 	case SKSE::MessagingInterface::kDataLoaded:
 		{
+			const Trace::Zone zone{ "kDataLoaded" };
+
 			std::string tweaksError{};
 			if (tweaks == nullptr) {
 				tweaksError = "powerofthree's Tweaks is not installed!\n";
@@ -62,7 +80,10 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_message)
 				RE::DebugMessageBox(error.c_str());
 			}
 
-			Cache::DataHolder::GetSingleton()->GetData();
+			{
+				const Trace::Zone dataZone{ "Cache::GetData" };
+				Cache::DataHolder::GetSingleton()->GetData();
+			}
 
 			logger::info("{:*^30}", "CONFIG");
 
@@ -72,19 +93,73 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_message)
 				std::filesystem::create_directory(seasonsPath);
 			}
 
-			SnowSwap::Manager::GetSingleton()->LoadSnowShaderSettings();
+			const auto snowManager = SnowSwap::Manager::GetSingleton();
+			{
+				const Trace::Zone snowZone{ "LoadSnowShaderSettings" };
+				snowManager->LoadSnowShaderSettings();
+			}
+			{
+				const Trace::Zone snowZone{ "LoadSnowTypeCache" };
+				snowManager->LoadSnowTypeCache();
+			}
+			//the deferred save below never runs if the game quits first, does nothing if it already did
+			Scheduler::Manager::GetSingleton()->OnQuit([snowManager] {
+				snowManager->SaveSnowTypeCache();
+			});
+			//the startup trace is written once both this handler and the background snow classification have finished
+			const auto writeTrace = [remaining = std::make_shared<std::atomic_uint32_t>(2)]() {
+				if (remaining->fetch_sub(1) == 1) {
+					Trace::Write();
+				}
+			};
+			{
+				const Trace::Zone snowZone{ "PrecomputeSnowTypes" };
+				snowManager->PrecomputeSnowTypes(writeTrace);
+			}
 
 			const auto manager = SeasonManager::GetSingleton();
-			manager->LoadOrGenerateWinterFormSwap();
-			manager->LoadSeasonData();
+			{
+				const Trace::Zone seasonZone{ "LoadOrGenerateWinterFormSwap" };
+				manager->LoadOrGenerateWinterFormSwap();
+			}
+			{
+				const Trace::Zone seasonZone{ "LoadSeasonData" };
+				manager->LoadSeasonData();
+			}
 			manager->RegisterEvents();
-			manager->CleanupSerializedSeasonList();
+			{
+				const Trace::Zone seasonZone{ "CleanupSerializedSeasonList" };
+				manager->CleanupSerializedSeasonList();
+			}
+
+			const auto cellIndex = CellIndex::Manager::GetSingleton();
+			{
+				const Trace::Zone cellZone{ "BuildSwappableBases" };
+				cellIndex->BuildSwappableBases();
+			}
+			cellIndex->Register();
+
+			memory::log_plugin_stats();
+
+			//first frame, after the kDataLoaded zone above has closed
+			Scheduler::Manager::GetSingleton()->Queue("startup trace", Scheduler::PRIORITY::kLow, [writeTrace](float) {
+				writeTrace();
+				return true;
+			});
 		}
 		break;
 	case SKSE::MessagingInterface::kSaveGame:
 		{
 			std::string_view savePath{ static_cast<char*>(a_message->data), a_message->dataLen };
 			SeasonManager::GetSingleton()->SaveSeason(savePath);
+
+			//written out a few frames later, away from the save hitch, or on quit (see kDataLoaded)
+			const auto scheduler = Scheduler::Manager::GetSingleton();
+			scheduler->Cancel("snow type cache"sv);
+			scheduler->Queue("snow type cache", Scheduler::PRIORITY::kLow, [](float) {
+				SnowSwap::Manager::GetSingleton()->SaveSnowTypeCache();
+				return true;
+			});
 		}
 		break;
 	case SKSE::MessagingInterface::kPreLoadGame:
@@ -93,6 +168,7 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_message)
 			string::replace_last_instance(savePath, ".ess", "");
 
 			SeasonManager::GetSingleton()->LoadSeason(savePath);
+			CellIndex::Manager::GetSingleton()->ClearBufferedCells();
 		}
 		break;
 	case SKSE::MessagingInterface::kDeleteGame:
@@ -146,7 +222,7 @@ extern "C" DLLEXPORT bool SKSEAPI SKSEPlugin_Query(const SKSE::QueryInterface* a
 }
 #endif
 
-void InitializeLog()
+void InitializeLog(bool a_asyncLogging)
 {
 	auto path = logger::log_directory();
 	if (!path) {
@@ -156,20 +232,62 @@ void InitializeLog()
 	*path /= fmt::format(FMT_STRING("{}.log"), Version::PROJECT);
 	auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(path->string(), true);
 
-	auto log = std::make_shared<spdlog::logger>("global log"s, std::move(sink));
+	std::shared_ptr<spdlog::logger> log;
+	if (a_asyncLogging) {
+		//stays the default logger until the process exits, loader threads can log right up to it
+		static std::shared_ptr<spdlog::logger> asyncLog;
+
+		//lines are formatted into a bounded queue and written by one background thread
+		spdlog::init_thread_pool(8192, 1);
+		asyncLog = std::make_shared<spdlog::async_logger>("global log"s, sink, spdlog::thread_pool(), spdlog::async_overflow_policy::block);
+		asyncLog->flush_on(spdlog::level::warn);  //threshold, errors and critical messages are flushed too
+		spdlog::flush_every(1s);
+		log = asyncLog;
+
+		//the process terminates the writer thread before atexit handlers run, so drain it while it is still alive
+		Scheduler::Manager::GetSingleton()->OnQuit([] {
+			logger::info("Flushing async log");
+			asyncLog->flush();
+
+			const auto deadline = std::chrono::steady_clock::now() + 500ms;
+			while (spdlog::thread_pool()->queue_size() > 0 && std::chrono::steady_clock::now() < deadline) {
+				std::this_thread::sleep_for(1ms);
+			}
+		});
+
+		//no other thread is left by then. Registered before Profiler::Init, so it runs after Profiler::Dump
+		//lines queued once the writer is gone (Profiler::Dump's summary) are dropped, the profile json is still written
+		std::atexit([] {
+			spdlog::shutdown();
+		});
+	} else {
+		log = std::make_shared<spdlog::logger>("global log"s, std::move(sink));
+		log->flush_on(spdlog::level::info);
+	}
 
 	log->set_level(spdlog::level::info);
-	log->flush_on(spdlog::level::info);
 
 	spdlog::set_default_logger(std::move(log));
 	spdlog::set_pattern("[%H:%M:%S:%e] %v"s);
 
 	logger::info(FMT_STRING("{} v{}"), Version::PROJECT, Version::NAME);
+	if (a_asyncLogging) {
+		logger::info("Async logging enabled");
+	}
 }
 
 extern "C" DLLEXPORT bool SKSEAPI SKSEPlugin_Load(const SKSE::LoadInterface* a_skse)
 {
-	InitializeLog();
+	//read before settings are loaded, the keys are written out by SeasonManager::LoadSettings
+	CSimpleIniA ini;
+	ini.SetUnicode();
+	ini.LoadFile(SeasonManager::settings);
+
+	InitializeLog(ini.GetBoolValue("Performance", "Async Logging", false));
+	if (ini.GetBoolValue("Performance", "Startup Trace", false)) {
+		Trace::Enable();
+	}
+	Profiler::Init();
 
 	logger::info("Game version : {}", a_skse->RuntimeVersion().string());
 
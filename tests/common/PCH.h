@@ -0,0 +1,35 @@
+#pragma once
+
+//Stand-in for include/PCH.h, to build plugin sources that make no engine calls without CommonLib.
+//Engine types are only declared and logging is dropped
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "Containers.h"
+#include "MemoryUsage.h"
+
+namespace RE
+{
+	using FormID = std::uint32_t;
+
+	class TESBoundObject;
+}
+
+namespace logger
+{
+	template <class... Args>
+	void info(Args&&...)
+	{}
+}
+
+using namespace std::literals;
@@ -0,0 +1,285 @@
+#include "FormIDSet.h"
+#include "OriginalBases.h"
+#include "SwapLookup.h"
+#include "SwapMemo.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <latch>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+//Lock contention on the lookups each queued reference goes through (FormSwap::GetHandle), from 1 to N threads.
+//Runs the plugin's OriginalBases, FormIDSet, swap map lookup and SwapMemo over synthetic references
+//usage: contention_bench [--threads N] [--writes P] [--iterations N]
+
+namespace
+{
+	using FormID = std::uint32_t;
+	using clock = std::chrono::steady_clock;
+
+	struct Settings
+	{
+		std::uint32_t maxThreads{ std::max(std::thread::hardware_concurrency(), 1u) };
+		std::uint32_t writePercent{ 5 };     //share of operations that also take the originals lock exclusively
+		std::uint32_t iterations{ 100000 };  //per thread
+	};
+
+	//base forms only need an address, decisions carry it as the target
+	struct Form
+	{
+		FormID id;
+	};
+
+	//plugins, a light plugin, a quarter of the bases swapped and a third of their references already swapped
+	class World
+	{
+	public:
+		World()
+		{
+			std::mt19937 rng{ 1234 };
+
+			std::vector<FormID> bases;
+			for (FormID plugin : { 0x00000000u, 0x01000000u, 0x02000000u }) {
+				for (FormID i = 0; i < 1200; ++i) {
+					bases.push_back(plugin | (0x800 + i * 7));
+				}
+			}
+			for (FormID i = 0; i < 400; ++i) {
+				bases.push_back(0xFE000000u | ((i % 4) << 12) | (0x800 + i));
+			}
+
+			for (const auto base : bases) {
+				add_form(base);
+				if (rng() % 4 == 0) {
+					const auto target = base ^ 0x00100000u;
+					add_form(target);
+					swaps.emplace(base, target);
+					swapBasesAndTargets.insert(base);
+					swapBasesAndTargets.insert(target);
+				}
+			}
+
+			for (FormID i = 0; i < 100000; ++i) {
+				const auto ref = 0x03000000u | (0x800 + i);
+				const auto base = bases[rng() % bases.size()];
+				const auto target = SwapLookup::find(swaps, base);
+
+				refs.push_back(ref);
+				if (target != 0 && rng() % 3 == 0) {
+					currentBases.push_back(target);
+					originals.emplace(ref, base);
+				} else {
+					currentBases.push_back(base);
+				}
+				expected.push_back(lookup(target != 0 ? target : base));
+			}
+		}
+
+		//TESForm::LookupByID
+		[[nodiscard]] RE::TESBoundObject* lookup(FormID a_formID) const
+		{
+			const auto it = formIndex.find(a_formID);
+			return it != formIndex.end() ? reinterpret_cast<RE::TESBoundObject*>(const_cast<Form*>(&forms[it->second])) : nullptr;
+		}
+
+		//update_base without the per cell batch : original base, swap candidates, memo, then the swap map
+		[[nodiscard]] RE::TESBoundObject* resolve(std::size_t a_index, bool a_write, std::uint32_t a_epoch)
+		{
+			const auto ref = refs[a_index];
+
+			auto base = originals.find(ref);
+			if (base == 0) {
+				base = currentBases[a_index];
+			}
+			if (a_write) {
+				originals.emplace(ref, base);  //set_original_base, keeps the first original so results don't change
+			}
+
+			if (!swapBasesAndTargets.contains(base)) {
+				return lookup(base);
+			}
+
+			const auto memo = SwapMemo::Manager::GetSingleton();
+			if (const auto decision = memo->Find(ref, a_epoch)) {
+				memo->CountLookup(ref, true);
+				return decision->target;
+			}
+			memo->CountLookup(ref, false);
+
+			const auto swap = SwapLookup::find(swaps, base);
+			const SwapMemo::Decision decision{ currentBases[a_index], lookup(swap != 0 ? swap : base), swap != 0 };
+			memo->Record(ref, decision, a_epoch);
+
+			return decision.target;
+		}
+
+		std::vector<FormID> refs;
+		std::vector<RE::TESBoundObject*> expected;
+
+	private:
+		void add_form(FormID a_formID)
+		{
+			formIndex.emplace(a_formID, forms.size());
+			forms.push_back({ a_formID });
+		}
+
+		std::vector<Form> forms;
+		Map<FormID, std::size_t> formIndex;
+
+		std::vector<FormID> currentBases;
+		MapPair<FormID> swaps;
+		FormIDSet swapBasesAndTargets;
+		OriginalBases originals;
+	};
+
+	struct RunResult
+	{
+		double seconds{ 0.0 };
+		std::vector<double> latencies{};  //ns
+		std::size_t mismatches{ 0 };
+	};
+
+	RunResult run(World& a_world, std::uint32_t a_threads, std::uint32_t a_epoch, const Settings& a_settings)
+	{
+		//a fresh memo per run, so every thread count starts from the same misses
+		SwapMemo::Manager::GetSingleton()->OnEpochChange(a_epoch);
+
+		std::vector<std::vector<double>> latencies(a_threads);
+		std::atomic<std::size_t> mismatches{ 0 };
+
+		std::latch ready{ static_cast<std::ptrdiff_t>(a_threads) + 1 };
+
+		std::vector<std::jthread> threads;
+		threads.reserve(a_threads);
+		for (std::uint32_t i = 0; i < a_threads; ++i) {
+			threads.emplace_back([&, i] {
+				auto& threadLatencies = latencies[i];
+				threadLatencies.reserve(a_settings.iterations);
+
+				std::mt19937 rng{ i + 1 };
+				std::uniform_int_distribution<std::size_t> refDist(0, a_world.refs.size() - 1);
+				std::uniform_int_distribution<std::uint32_t> opDist(0, 99);
+
+				std::size_t threadMismatches = 0;
+
+				ready.arrive_and_wait();
+
+				for (std::uint32_t j = 0; j < a_settings.iterations; ++j) {
+					const auto index = refDist(rng);
+					const bool write = opDist(rng) < a_settings.writePercent;
+
+					const auto start = clock::now();
+					const auto target = a_world.resolve(index, write, a_epoch);
+					threadLatencies.push_back(std::chrono::duration<double, std::nano>(clock::now() - start).count());
+
+					if (target != a_world.expected[index]) {
+						++threadMismatches;
+					}
+				}
+
+				mismatches += threadMismatches;
+			});
+		}
+
+		ready.arrive_and_wait();
+		const auto start = clock::now();
+
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		RunResult result;
+		result.seconds = std::chrono::duration<double>(clock::now() - start).count();
+		for (auto& threadLatencies : latencies) {
+			result.latencies.insert(result.latencies.end(), threadLatencies.begin(), threadLatencies.end());
+		}
+		result.mismatches = mismatches;
+
+		return result;
+	}
+
+	double percentile(const std::vector<double>& a_sorted, double a_fraction)
+	{
+		if (a_sorted.empty()) {
+			return 0.0;
+		}
+		const auto idx = std::min(a_sorted.size() - 1, static_cast<std::size_t>(a_fraction * static_cast<double>(a_sorted.size())));
+		return a_sorted[idx];
+	}
+
+	bool parse_count(std::string_view a_value, std::uint32_t& a_count, std::uint32_t a_min, std::uint32_t a_max)
+	{
+		return std::from_chars(a_value.data(), a_value.data() + a_value.size(), a_count).ec == std::errc{} && a_count >= a_min && a_count <= a_max;
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	Settings settings;
+
+	for (int i = 1; i < a_argc; ++i) {
+		const std::string_view arg{ a_argv[i] };
+		const bool hasValue = i + 1 < a_argc;
+		if (arg == "--threads" && hasValue) {
+			if (!parse_count(a_argv[++i], settings.maxThreads, 1, 256)) {
+				std::printf("invalid thread count: %s\n", a_argv[i]);
+				return 1;
+			}
+		} else if (arg == "--writes" && hasValue) {
+			if (!parse_count(a_argv[++i], settings.writePercent, 0, 100)) {
+				std::printf("invalid write percentage: %s\n", a_argv[i]);
+				return 1;
+			}
+		} else if (arg == "--iterations" && hasValue) {
+			if (!parse_count(a_argv[++i], settings.iterations, 1, UINT32_MAX)) {
+				std::printf("invalid iteration count: %s\n", a_argv[i]);
+				return 1;
+			}
+		} else {
+			std::printf("usage: contention_bench [--threads N] [--writes P] [--iterations N]\n");
+			return 1;
+		}
+	}
+
+	World world;
+
+	std::printf("%zu refs, %u%% writes, %u ops per thread\n", world.refs.size(), settings.writePercent, settings.iterations);
+
+	double baseThroughput = 0.0;
+	std::size_t mismatches = 0;
+	std::uint32_t epoch = 0;
+
+	//powers of two, and the requested maximum
+	for (std::uint32_t threads = 1;; threads = std::min(threads * 2, settings.maxThreads)) {
+		auto [seconds, latencies, runMismatches] = run(world, threads, ++epoch, settings);
+		std::ranges::sort(latencies);
+
+		const auto throughput = static_cast<double>(latencies.size()) / seconds;
+		if (threads == 1) {
+			baseThroughput = throughput;
+		}
+
+		std::printf("%3u threads : %7.2f Mops/s (%5.2fx) | p50 %6.0f ns | p99 %6.0f ns | p99.9 %7.0f ns | max %8.0f ns\n",
+			threads, throughput / 1e6, baseThroughput > 0.0 ? throughput / baseThroughput : 0.0,
+			percentile(latencies, 0.5), percentile(latencies, 0.99), percentile(latencies, 0.999), latencies.empty() ? 0.0 : latencies.back());
+
+		mismatches += runMismatches;
+
+		if (threads == settings.maxThreads) {
+			break;
+		}
+	}
+
+	if (mismatches != 0) {
+		std::printf("%zu references resolved to the wrong base\n", mismatches);
+		return 1;
+	}
+	return 0;
+}
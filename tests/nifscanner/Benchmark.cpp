@@ -0,0 +1,130 @@
+#include "NifScanner.h"
+#include "SyntheticNif.h"
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+//Scan throughput over a synthetic corpus, or over a directory of extracted meshes
+//usage: nifscanner_bench [--iterations N] [mesh directory]
+
+using NifScanner::RESULT;
+
+namespace
+{
+	using clock = std::chrono::steady_clock;
+
+	struct Totals
+	{
+		std::size_t files{ 0 };
+		std::size_t bytes{ 0 };
+		std::array<std::size_t, 3> results{};
+	};
+
+	void print(std::string_view a_name, const Totals& a_totals, clock::duration a_elapsed)
+	{
+		const auto seconds = std::chrono::duration<double>(a_elapsed).count();
+		std::printf("%.*s: %zu files, %.2f MB in %.3f ms | %.0f files/s | %.1f MB/s | %.2f us/file\n",
+			static_cast<int>(a_name.size()), a_name.data(),
+			a_totals.files, a_totals.bytes / (1024.0 * 1024.0), seconds * 1000.0,
+			a_totals.files / seconds, a_totals.bytes / (1024.0 * 1024.0) / seconds,
+			seconds * 1e6 / a_totals.files);
+		std::printf("\tmultipass %zu | singlepass %zu | unknown %zu\n",
+			a_totals.results[static_cast<std::size_t>(RESULT::kMultiPass)],
+			a_totals.results[static_cast<std::size_t>(RESULT::kSinglePass)],
+			a_totals.results[static_cast<std::size_t>(RESULT::kUnknown)]);
+	}
+
+	std::vector<SyntheticNif::Bytes> make_corpus()
+	{
+		using namespace SyntheticNif;
+
+		std::vector<Bytes> corpus;
+		for (std::uint16_t shapes = 1; shapes <= 64; shapes *= 2) {
+			for (std::uint16_t vertices : { 24, 300, 2000 }) {
+				corpus.push_back(make_large_static(shapes, vertices).build());
+			}
+		}
+		corpus.push_back(make_static().build());
+		corpus.push_back(make_static(SKINNED_FLAG).build());
+		corpus.push_back(make_static(0, ALPHA_TEST_FLAG).build());
+		corpus.push_back(make_static(0, -1, 36, "NiNode").build());
+		return corpus;
+	}
+
+	void bench_synthetic(std::size_t a_iterations)
+	{
+		const auto corpus = make_corpus();
+
+		Totals totals;
+		const auto start = clock::now();
+		for (std::size_t i = 0; i < a_iterations; ++i) {
+			for (const auto& file : corpus) {
+				const auto result = NifScanner::Scan(file);
+				++totals.results[static_cast<std::size_t>(result)];
+				++totals.files;
+				totals.bytes += file.size();
+			}
+		}
+		print("synthetic", totals, clock::now() - start);
+	}
+
+	void bench_directory(const std::filesystem::path& a_dir, std::size_t a_iterations)
+	{
+		std::vector<std::filesystem::path> paths;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(a_dir, std::filesystem::directory_options::skip_permission_denied)) {
+			if (entry.is_regular_file() && entry.path().extension() == ".nif") {
+				paths.push_back(entry.path());
+			}
+		}
+		if (paths.empty()) {
+			std::printf("no .nif files found in %s\n", a_dir.string().c_str());
+			return;
+		}
+
+		//first pass includes mapping and page faults, later passes run from the page cache
+		for (std::size_t i = 0; i < a_iterations; ++i) {
+			Totals totals;
+			const auto start = clock::now();
+			for (const auto& path : paths) {
+				const NifScanner::MappedFile file{ path };
+				const auto result = file.is_open() ? NifScanner::Scan(file.data()) : RESULT::kUnknown;
+				++totals.results[static_cast<std::size_t>(result)];
+				++totals.files;
+				totals.bytes += file.data().size();
+			}
+			print(i == 0 ? "directory (cold)" : "directory", totals, clock::now() - start);
+		}
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	std::size_t iterations = 1000;
+	std::filesystem::path dir;
+
+	for (int i = 1; i < a_argc; ++i) {
+		const std::string_view arg{ a_argv[i] };
+		if (arg == "--iterations" && i + 1 < a_argc) {
+			const std::string_view value{ a_argv[++i] };
+			if (std::from_chars(value.data(), value.data() + value.size(), iterations).ec != std::errc{} || iterations == 0) {
+				std::printf("invalid iteration count: %s\n", a_argv[i]);
+				return 1;
+			}
+		} else {
+			dir = arg;
+		}
+	}
+
+	if (dir.empty()) {
+		bench_synthetic(iterations);
+	} else {
+		bench_directory(dir, iterations);
+	}
+
+	return 0;
+}
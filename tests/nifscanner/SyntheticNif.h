@@ -0,0 +1,265 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//Writes small synthetic SSE (20.2.0.7, BS 100) NIFs, with the block layouts NifScanner reads
+namespace SyntheticNif
+{
+	using Bytes = std::vector<std::byte>;
+
+	constexpr std::uint32_t SKINNED_FLAG{ 1 << 1 };
+	constexpr std::uint16_t ALPHA_BLEND_FLAG{ 1 << 0 };
+	constexpr std::uint16_t ALPHA_TEST_FLAG{ 1 << 9 };
+
+	class Writer
+	{
+	public:
+		template <class T>
+		Writer& write(T a_value)
+		{
+			const auto pos = _data.size();
+			_data.resize(pos + sizeof(T));
+			std::memcpy(_data.data() + pos, &a_value, sizeof(T));
+			return *this;
+		}
+
+		Writer& write_string(std::string_view a_str)
+		{
+			const auto pos = _data.size();
+			_data.resize(pos + a_str.size());
+			std::memcpy(_data.data() + pos, a_str.data(), a_str.size());
+			return *this;
+		}
+
+		Writer& write_sized_string(std::string_view a_str)
+		{
+			write(static_cast<std::uint32_t>(a_str.size()));
+			return write_string(a_str);
+		}
+
+		Writer& write_export_string(std::string_view a_str)
+		{
+			write(static_cast<std::uint8_t>(a_str.size()));
+			return write_string(a_str);
+		}
+
+		Writer& zero(std::size_t a_bytes)
+		{
+			_data.reserve(_data.size() + a_bytes);
+			std::fill_n(std::back_inserter(_data), a_bytes, std::byte{ 0 });
+			return *this;
+		}
+
+		Writer& append(const Bytes& a_bytes)
+		{
+			_data.insert(_data.end(), a_bytes.begin(), a_bytes.end());
+			return *this;
+		}
+
+		[[nodiscard]] Bytes& data() { return _data; }
+
+	private:
+		Bytes _data;
+	};
+
+	//NiObjectNET: name, extra data list, controller
+	inline void write_object_net(Writer& a_writer)
+	{
+		a_writer.write<std::int32_t>(-1).write<std::uint32_t>(0).write<std::int32_t>(-1);
+	}
+
+	//NiAVObject: flags, translation, rotation, scale, collision
+	inline void write_av_object(Writer& a_writer)
+	{
+		write_object_net(a_writer);
+		a_writer.write<std::uint32_t>(14).zero(12 + 36).write(1.0f).write<std::int32_t>(-1);
+	}
+
+	struct Block
+	{
+		std::string type;
+		Bytes data;
+	};
+
+	struct Options
+	{
+		std::uint32_t version{ 0x14020007 };
+		std::uint32_t userVersion{ 12 };
+		std::uint32_t bsVersion{ 100 };
+		std::string   headerString{ "Gamebryo File Format, Version 20.2.0.7" };
+	};
+
+	class Nif
+	{
+	public:
+		std::int32_t node(std::string_view a_type, const std::vector<std::int32_t>& a_children)
+		{
+			Writer writer;
+			write_av_object(writer);
+			writer.write(static_cast<std::uint32_t>(a_children.size()));
+			for (const auto child : a_children) {
+				writer.write(child);
+			}
+			writer.write<std::uint32_t>(0);  //effects
+			return add(a_type, writer);
+		}
+
+		std::int32_t tri_shape(std::int32_t a_shader, std::int32_t a_alpha, std::uint16_t a_numVertices, std::string_view a_type = "BSTriShape")
+		{
+			Writer writer;
+			write_av_object(writer);
+			writer.zero(16);                   //bounding sphere
+			writer.write<std::int32_t>(-1);    //skin
+			writer.write(a_shader);
+			writer.write(a_alpha);
+			writer.write<std::uint64_t>(0x0430000000000000);  //vertex desc
+			writer.write<std::uint16_t>(a_numVertices / 3);  //triangles
+			writer.write(a_numVertices);
+			writer.write<std::uint32_t>(a_numVertices * 16u);  //data size
+			writer.zero(a_numVertices * 16u);                  //vertex data, never read
+			return add(a_type, writer);
+		}
+
+		std::int32_t lighting_shader(std::uint32_t a_flags1)
+		{
+			Writer writer;
+			writer.write<std::uint32_t>(0);  //shader type
+			write_object_net(writer);
+			writer.write(a_flags1);
+			writer.write<std::uint32_t>(0);  //flags2
+			writer.zero(8 + 8 + 4);          //uv offset/scale, texture set
+			return add("BSLightingShaderProperty", writer);
+		}
+
+		std::int32_t alpha_property(std::uint16_t a_flags)
+		{
+			Writer writer;
+			write_object_net(writer);
+			writer.write(a_flags);
+			writer.write<std::uint8_t>(128);  //threshold
+			return add("NiAlphaProperty", writer);
+		}
+
+		std::int32_t opaque(std::string_view a_type, std::size_t a_size)
+		{
+			Writer writer;
+			writer.zero(a_size);
+			return add(a_type, writer);
+		}
+
+		[[nodiscard]] std::vector<Block>& blocks() { return _blocks; }
+		[[nodiscard]] std::vector<std::int32_t>& roots() { return _roots; }
+
+		//offset of the first block, anything cut before this is a truncated header
+		[[nodiscard]] std::size_t header_size(const Options& a_options = {}) const
+		{
+			return write_header(a_options).data().size();
+		}
+
+		[[nodiscard]] Bytes build(const Options& a_options = {}) const
+		{
+			auto writer = write_header(a_options);
+			for (const auto& block : _blocks) {
+				writer.append(block.data);
+			}
+			writer.write(static_cast<std::uint32_t>(_roots.size()));
+			for (const auto root : _roots) {
+				writer.write(root);
+			}
+			return std::move(writer.data());
+		}
+
+	private:
+		std::int32_t add(std::string_view a_type, Writer& a_writer)
+		{
+			_blocks.push_back({ std::string(a_type), std::move(a_writer.data()) });
+			return static_cast<std::int32_t>(_blocks.size() - 1);
+		}
+
+		[[nodiscard]] Writer write_header(const Options& a_options) const
+		{
+			Writer writer;
+			writer.write_string(a_options.headerString).write('\n');
+			writer.write(a_options.version);
+			writer.write<std::uint8_t>(1);  //little endian
+			writer.write(a_options.userVersion);
+			writer.write(static_cast<std::uint32_t>(_blocks.size()));
+			writer.write(a_options.bsVersion);
+			writer.write_export_string("SyntheticNif");
+			writer.write_export_string("");
+			writer.write_export_string("");
+
+			std::vector<std::string_view> types;
+			std::vector<std::uint16_t>    typeIndices;
+			for (const auto& block : _blocks) {
+				auto it = std::find(types.begin(), types.end(), block.type);
+				if (it == types.end()) {
+					it = types.insert(types.end(), block.type);
+				}
+				typeIndices.push_back(static_cast<std::uint16_t>(it - types.begin()));
+			}
+
+			writer.write(static_cast<std::uint16_t>(types.size()));
+			for (const auto type : types) {
+				writer.write_sized_string(type);
+			}
+			for (const auto index : typeIndices) {
+				writer.write(index);
+			}
+			for (const auto& block : _blocks) {
+				writer.write(static_cast<std::uint32_t>(block.data.size()));
+			}
+
+			writer.write<std::uint32_t>(1);  //strings
+			writer.write<std::uint32_t>(5);  //max string length
+			writer.write_sized_string("Scene");
+			writer.write<std::uint32_t>(0);  //groups
+
+			return writer;
+		}
+
+		std::vector<Block>        _blocks;
+		std::vector<std::int32_t> _roots{ 0 };
+	};
+
+	//BSFadeNode -> BSTriShape -> BSLightingShaderProperty (+ optional NiAlphaProperty)
+	inline Nif make_static(std::uint32_t a_shaderFlags1 = 0, std::int32_t a_alphaFlags = -1, std::uint16_t a_numVertices = 36, std::string_view a_rootType = "BSFadeNode")
+	{
+		Nif nif;
+		nif.node(a_rootType, { 1 });
+		nif.tri_shape(2, a_alphaFlags >= 0 ? 3 : -1, a_numVertices);
+		nif.lighting_shader(a_shaderFlags1);
+		if (a_alphaFlags >= 0) {
+			nif.alpha_property(static_cast<std::uint16_t>(a_alphaFlags));
+		}
+		return nif;
+	}
+
+	//BSFadeNode with a NiNode per shape, roughly the size of a rock or building static
+	inline Nif make_large_static(std::size_t a_numShapes, std::uint16_t a_numVertices)
+	{
+		Nif nif;
+
+		std::vector<std::int32_t> children;
+		for (std::size_t i = 0; i < a_numShapes; ++i) {
+			children.push_back(static_cast<std::int32_t>(1 + i * 3));
+		}
+		nif.node("BSFadeNode", children);
+
+		for (std::size_t i = 0; i < a_numShapes; ++i) {
+			const auto index = static_cast<std::int32_t>(1 + i * 3);
+			nif.node("NiNode", { index + 1 });
+			nif.tri_shape(index + 2, -1, a_numVertices);
+			nif.lighting_shader(0);
+		}
+
+		return nif;
+	}
+}
@@ -0,0 +1,319 @@
+#include "NifScanner.h"
+#include "SyntheticNif.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using NifScanner::RESULT;
+
+namespace
+{
+	int failures{ 0 };
+
+	std::string_view to_string(RESULT a_result)
+	{
+		switch (a_result) {
+		case RESULT::kSinglePass:
+			return "kSinglePass";
+		case RESULT::kMultiPass:
+			return "kMultiPass";
+		default:
+			return "kUnknown";
+		}
+	}
+
+	void check(bool a_condition, std::string_view a_test, std::string_view a_what)
+	{
+		if (!a_condition) {
+			std::printf("FAIL %.*s: %.*s\n", static_cast<int>(a_test.size()), a_test.data(), static_cast<int>(a_what.size()), a_what.data());
+			++failures;
+		}
+	}
+
+	void check_result(std::string_view a_test, const SyntheticNif::Bytes& a_data, RESULT a_expected)
+	{
+		const auto result = NifScanner::Scan(a_data);
+		if (result != a_expected) {
+			std::printf("FAIL %.*s: expected %.*s, got %.*s\n",
+				static_cast<int>(a_test.size()), a_test.data(),
+				static_cast<int>(to_string(a_expected).size()), to_string(a_expected).data(),
+				static_cast<int>(to_string(result).size()), to_string(result).data());
+			++failures;
+		}
+	}
+
+	void test_classification()
+	{
+		using namespace SyntheticNif;
+
+		check_result("fade node static", make_static().build(), RESULT::kMultiPass);
+		check_result("leaf anim node static", make_static(0, -1, 36, "BSLeafAnimNode").build(), RESULT::kMultiPass);
+		check_result("ninode root", make_static(0, -1, 36, "NiNode").build(), RESULT::kSinglePass);
+		check_result("skinned shader", make_static(SKINNED_FLAG).build(), RESULT::kSinglePass);
+		check_result("alpha blend", make_static(0, ALPHA_BLEND_FLAG).build(), RESULT::kSinglePass);
+		check_result("alpha test", make_static(0, ALPHA_TEST_FLAG).build(), RESULT::kSinglePass);
+		check_result("alpha property without blending", make_static(0, 0).build(), RESULT::kMultiPass);
+		check_result("no vertices", make_static(0, -1, 0).build(), RESULT::kSinglePass);
+		check_result("large static", make_large_static(32, 300).build(), RESULT::kMultiPass);
+
+		{
+			Nif nif;
+			nif.node("BSFadeNode", { 1 });
+			nif.node("NiNode", {});
+			check_result("no geometry", nif.build(), RESULT::kSinglePass);
+		}
+		{
+			Nif nif;
+			nif.node("BSFadeNode", { 1 });
+			nif.tri_shape(2, -1, 36, "BSSubIndexTriShape");
+			nif.lighting_shader(0);
+			check_result("subindex trishape", nif.build(), RESULT::kMultiPass);
+		}
+		{
+			Nif nif;
+			nif.node("BSFadeNode", { 1 });
+			nif.tri_shape(2, -1, 36);
+			nif.opaque("BSEffectShaderProperty", 64);
+			check_result("effect shader", nif.build(), RESULT::kSinglePass);
+		}
+		{
+			Nif nif;
+			nif.node("BSFadeNode", { 1, 2 });
+			nif.opaque("NiParticleSystem", 64);
+			nif.tri_shape(3, -1, 36);
+			nif.lighting_shader(0);
+			check_result("particles", nif.build(), RESULT::kUnknown);
+		}
+		{
+			//one failing shape is enough
+			Nif nif;
+			nif.node("BSFadeNode", { 1, 3 });
+			nif.tri_shape(2, -1, 36);
+			nif.lighting_shader(0);
+			nif.tri_shape(4, -1, 36);
+			nif.lighting_shader(SKINNED_FLAG);
+			check_result("mixed shapes", nif.build(), RESULT::kSinglePass);
+		}
+		{
+			//shapes reached through multiple roots
+			Nif nif;
+			nif.node("BSFadeNode", { 1 });
+			nif.tri_shape(2, -1, 36);
+			nif.lighting_shader(0);
+			nif.node("BSFadeNode", { 4 });
+			nif.tri_shape(5, -1, 36);
+			nif.lighting_shader(SKINNED_FLAG);
+			nif.roots() = { 0, 3 };
+			check_result("multiple roots", nif.build(), RESULT::kSinglePass);
+		}
+	}
+
+	void test_header()
+	{
+		using namespace SyntheticNif;
+
+		const auto nif = make_static();
+
+		check_result("empty", {}, RESULT::kUnknown);
+
+		Options oblivion;
+		oblivion.version = 0x14000005;
+		oblivion.headerString = "Gamebryo File Format, Version 20.0.0.5";
+		check_result("oblivion version", nif.build(oblivion), RESULT::kUnknown);
+
+		Options le;
+		le.bsVersion = 83;
+		check_result("LE bs version", nif.build(le), RESULT::kUnknown);
+
+		Options fo4;
+		fo4.bsVersion = 130;
+		check_result("FO4 bs version", nif.build(fo4), RESULT::kUnknown);
+
+		Options userVersion;
+		userVersion.userVersion = 0;
+		check_result("user version", nif.build(userVersion), RESULT::kUnknown);
+
+		Options magic;
+		magic.headerString = "NetImmerse File Format, Version 4.0.0.2";
+		check_result("netimmerse magic", nif.build(magic), RESULT::kUnknown);
+
+		{
+			//no newline after the header string
+			auto data = nif.build();
+			data.resize(nif.header_size() / 2);
+			for (auto& byte : data) {
+				if (byte == std::byte{ '\n' }) {
+					byte = std::byte{ ' ' };
+				}
+			}
+			check_result("unterminated header string", data, RESULT::kUnknown);
+		}
+	}
+
+	void test_truncated()
+	{
+		using namespace SyntheticNif;
+
+		const std::vector<std::pair<std::string_view, Nif>> files{
+			{ "truncated multipass", make_static() },
+			{ "truncated alpha", make_static(0, ALPHA_TEST_FLAG) },
+			{ "truncated large", make_large_static(4, 12) }
+		};
+
+		for (const auto& [name, nif] : files) {
+			const auto data = nif.build();
+			const auto expected = NifScanner::Scan(data);
+			const auto headerSize = nif.header_size();
+
+			for (std::size_t size = 0; size < data.size(); ++size) {
+				const std::span<const std::byte> prefix{ data.data(), size };
+				const auto result = NifScanner::Scan(prefix);
+				if (size < headerSize) {
+					check(result == RESULT::kUnknown, name, "truncated header was classified");
+				} else {
+					//the footer and unread trailing fields can be cut without changing the verdict
+					check(result == RESULT::kUnknown || result == expected, name, "truncated file changed the verdict");
+				}
+			}
+		}
+	}
+
+	void test_malformed()
+	{
+		using namespace SyntheticNif;
+
+		const auto valid = make_static().build();
+		const auto nif = make_static();
+		const auto headerSize = nif.header_size();
+
+		{
+			Nif cyclic;
+			cyclic.node("BSFadeNode", { 0, 1 });
+			cyclic.node("NiNode", { 0, 1 });
+			check_result("cyclic children", cyclic.build(), RESULT::kSinglePass);
+		}
+		{
+			Nif dangling;
+			dangling.node("BSFadeNode", { 0x7FFFFFFF, -1, 5 });
+			dangling.node("NiNode", {});
+			dangling.node("NiNode", {});
+			check_result("dangling children", dangling.build(), RESULT::kSinglePass);
+		}
+		{
+			Nif shaderRef;
+			shaderRef.node("BSFadeNode", { 1 });
+			shaderRef.tri_shape(0, -1, 36);  //shader ref points at the root node
+			check_result("shader ref to node", shaderRef.build(), RESULT::kSinglePass);
+		}
+		{
+			Nif badShader;
+			badShader.node("BSFadeNode", { 1 });
+			badShader.tri_shape(42, 43, 36);
+			check_result("out of range shader ref", badShader.build(), RESULT::kSinglePass);
+		}
+		{
+			Nif badRoot = make_static();
+			badRoot.roots() = { 99 };
+			check_result("out of range root", badRoot.build(), RESULT::kSinglePass);
+		}
+		{
+			//block type index past the type table
+			auto data = valid;
+			const auto typeIndexOffset = headerSize - (3 * 4) - (4 + 4 + 4 + 5 + 4);  //3 block sizes, string table, groups
+			data[typeIndexOffset - 6] = std::byte{ 0x40 };
+			check_result("bad block type index", data, RESULT::kUnknown);
+		}
+		{
+			//numBlocks larger than the file
+			auto data = valid;
+			const auto numBlocksOffset = std::string_view{ "Gamebryo File Format, Version 20.2.0.7\n" }.size() + 4 + 1 + 4;
+			data[numBlocksOffset + 3] = std::byte{ 0x7F };
+			check_result("huge block count", data, RESULT::kUnknown);
+		}
+		{
+			//child count larger than the block count
+			auto data = valid;
+			const auto numChildrenOffset = headerSize + 12 + 4 + 12 + 36 + 4 + 4;
+			data[numChildrenOffset + 2] = std::byte{ 0x10 };
+			check_result("huge child count", data, RESULT::kUnknown);
+		}
+		{
+			//block sizes that overrun the file
+			auto data = valid;
+			const auto blockSizeOffset = headerSize - (4 + 4 + 4 + 5 + 4) - 3 * 4;
+			data[blockSizeOffset + 3] = std::byte{ 0x7F };
+			check_result("overrunning block size", data, RESULT::kUnknown);
+		}
+
+		//random corruption must never crash or read out of bounds
+		std::mt19937 rng{ 1234 };
+		for (std::size_t i = 0; i < 20000; ++i) {
+			auto data = valid;
+			const auto flips = 1 + rng() % 8;
+			for (std::size_t j = 0; j < flips; ++j) {
+				data[rng() % data.size()] = static_cast<std::byte>(rng());
+			}
+			if (rng() % 4 == 0) {
+				data.resize(rng() % data.size());
+			}
+			static_cast<void>(NifScanner::Scan(data));
+		}
+	}
+
+	void test_files()
+	{
+		using namespace SyntheticNif;
+
+		const auto dir = std::filesystem::temp_directory_path() / "sos_nifscanner_tests";
+		std::filesystem::create_directories(dir);
+
+		const auto write_file = [&](std::string_view a_name, const Bytes& a_data) {
+			auto path = dir / a_name;
+			std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+			file.write(reinterpret_cast<const char*>(a_data.data()), static_cast<std::streamsize>(a_data.size()));
+			return path;
+		};
+
+		const auto multiPass = write_file("multipass.nif", make_static().build());
+		const auto singlePass = write_file("singlepass.nif", make_static(SKINNED_FLAG).build());
+		const auto empty = write_file("empty.nif", {});
+
+		check(NifScanner::Scan(multiPass) == RESULT::kMultiPass, "mapped file", "multipass file");
+		check(NifScanner::Scan(singlePass) == RESULT::kSinglePass, "mapped file", "singlepass file");
+		check(NifScanner::Scan(empty) == RESULT::kUnknown, "mapped file", "empty file");
+		check(NifScanner::Scan(dir / "missing.nif") == RESULT::kUnknown, "mapped file", "missing file");
+
+		{
+			NifScanner::MappedFile file{ multiPass };
+			check(file.is_open() && file.data().size() == std::filesystem::file_size(multiPass), "mapped file", "size");
+
+			NifScanner::MappedFile moved{ std::move(file) };
+			check(!file.is_open() && moved.is_open(), "mapped file", "move");
+		}
+
+		std::filesystem::remove_all(dir);
+	}
+}
+
+int main()
+{
+	test_classification();
+	test_header();
+	test_truncated();
+	test_malformed();
+	test_files();
+
+	if (failures > 0) {
+		std::printf("%d checks failed\n", failures);
+		return 1;
+	}
+
+	std::printf("all checks passed\n");
+	return 0;
+}
@@ -0,0 +1,312 @@
+#include "OriginalBases.h"
+#include "SwapLookup.h"
+#include "SwapMemo.h"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+//Per-ref vs per-cell batched swap resolution (FormSwap::GetHandle::update_base / resolve_cell), without engine forms.
+//Runs the plugin's SwapMemo, OriginalBases, swap map lookup and per base grouping; forms and the season's swap rules are modelled.
+//Prints the smallest cell size where batching won, to pick "Cell Batch Refs"
+//usage: swapbatch_bench [--iterations N]
+
+namespace
+{
+	using FormID = std::uint32_t;
+	using clock = std::chrono::steady_clock;
+
+	using SwapMemo::Decision;
+	using SwapMemo::Decisions;
+
+	//TESBoundObject, decisions only carry its address
+	struct Form
+	{
+		FormID id;
+		std::uint8_t type;
+	};
+
+	RE::TESBoundObject* as_object(Form* a_form)
+	{
+		return reinterpret_cast<RE::TESBoundObject*>(a_form);
+	}
+
+	const Form* as_form(const RE::TESBoundObject* a_object)
+	{
+		return reinterpret_cast<const Form*>(a_object);
+	}
+
+	struct Ref
+	{
+		FormID id;
+		RE::TESBoundObject* base;
+	};
+
+	struct World
+	{
+		std::vector<std::unique_ptr<Form>> forms;
+		Map<FormID, RE::TESBoundObject*> formMap;  //TESForm::LookupByID
+		MapPair<FormID> swaps;                     //FormSwapMap of the current season
+		std::bitset<256> swapTypes;                //SEASON_STATE::swapFormTypes
+
+		OriginalBases originals;  //Cache::DataHolder
+
+		RE::TESBoundObject* add_form(FormID a_id, std::uint8_t a_type)
+		{
+			const auto object = as_object(forms.emplace_back(std::make_unique<Form>(Form{ a_id, a_type })).get());
+			formMap.emplace(a_id, object);
+			return object;
+		}
+
+		RE::TESBoundObject* lookup(FormID a_id) const
+		{
+			const auto it = formMap.find(a_id);
+			return it != formMap.end() ? it->second : nullptr;
+		}
+
+		RE::TESBoundObject* get_original_base(const Ref& a_ref) const
+		{
+			const auto originalID = originals.find(a_ref.id);
+			return originalID != 0 ? lookup(originalID) : a_ref.base;
+		}
+
+		std::vector<RE::TESBoundObject*> get_original_bases(const std::vector<const Ref*>& a_refs) const
+		{
+			const auto originalIDs = originals.find(a_refs, [](const Ref* a_ref) { return a_ref->id; });
+
+			std::vector<RE::TESBoundObject*> result;
+			result.reserve(a_refs.size());
+			for (std::size_t i = 0; i < a_refs.size(); ++i) {
+				result.push_back(originalIDs[i] != 0 ? lookup(originalIDs[i]) : a_refs[i]->base);
+			}
+			return result;
+		}
+
+		//FormSwap::detail::get_decision
+		Decision get_decision(RE::TESBoundObject* a_base, RE::TESBoundObject* a_origBase) const
+		{
+			RE::TESBoundObject* replaceBase = nullptr;
+			if (a_origBase && swapTypes.test(as_form(a_base)->type)) {
+				const auto swapID = SwapLookup::find(swaps, as_form(a_origBase)->id);
+				replaceBase = swapID != 0 ? lookup(swapID) : nullptr;
+			}
+			if (replaceBase) {
+				return { as_form(a_base)->id, replaceBase, replaceBase != a_base };
+			}
+			if (a_origBase && a_origBase != a_base) {
+				return { as_form(a_base)->id, a_origBase, false };
+			}
+			return { as_form(a_base)->id, a_base, false };
+		}
+	};
+
+	struct Cell
+	{
+		std::vector<Ref> refs;
+	};
+
+	FormID nextRefID{ 0x00100000 };
+	std::uint32_t epoch{ 0 };  //SwapMemo state epoch, one per timed pass
+
+	//a cell with a_numRefs references over a_numBases bases, in load order (unsorted by base)
+	Cell make_cell(World& a_world, std::mt19937& a_rng, std::size_t a_numRefs, std::size_t a_numBases)
+	{
+		const auto firstBase = static_cast<FormID>(a_world.forms.size());
+
+		for (std::size_t i = 0; i < a_numBases; ++i) {
+			a_world.add_form(0x01000800u + firstBase + static_cast<FormID>(i), static_cast<std::uint8_t>(a_rng() % 4 == 0 ? 24 : 36));  //trees, statics
+		}
+		for (std::size_t i = 0; i < a_numBases; ++i) {
+			if (a_rng() % 10 < 3) {
+				const auto id = 0x02000800u + firstBase + static_cast<FormID>(i);
+				a_world.add_form(id, 36);
+				a_world.swaps.emplace(0x01000800u + firstBase + static_cast<FormID>(i), id);
+			}
+		}
+
+		//a few bases are referenced a lot (rocks, clutter), most only a few times
+		std::geometric_distribution<std::size_t> skew{ 4.0 / static_cast<double>(a_numBases) };
+
+		Cell cell;
+		cell.refs.reserve(a_numRefs);
+		for (std::size_t i = 0; i < a_numRefs; ++i) {
+			const auto refID = nextRefID++;
+			const auto base = a_world.lookup(0x01000800u + firstBase + static_cast<FormID>(skew(a_rng) % a_numBases));
+			cell.refs.push_back({ refID, base });
+
+			//refs swapped in an earlier season remember their original
+			if (a_rng() % 10 == 0) {
+				a_world.originals.emplace(refID, as_form(base)->id);
+			}
+		}
+		return cell;
+	}
+
+	//resolve_base for every reference: original and decision per reference, in load order
+	void decide_per_ref(const World& a_world, const Cell& a_cell, Decisions& a_decisions)
+	{
+		a_decisions.clear();
+		for (const auto& ref : a_cell.refs) {
+			a_decisions.emplace_back(ref.id, a_world.get_decision(ref.base, a_world.get_original_base(ref)));
+		}
+	}
+
+	//resolve_cell: sorted by base, originals under one lock, one decision per (base, original)
+	void decide_batched(const World& a_world, const Cell& a_cell, Decisions& a_decisions)
+	{
+		std::vector<const Ref*> refs;
+		refs.reserve(a_cell.refs.size());
+		for (const auto& ref : a_cell.refs) {
+			refs.push_back(&ref);
+		}
+
+		std::ranges::sort(refs, {}, [](const Ref* a_ref) { return as_form(a_ref->base)->id; });
+
+		const auto origBases = a_world.get_original_bases(refs);
+
+		a_decisions.clear();
+		SwapMemo::decide_grouped(
+			refs, origBases,
+			[](const Ref* a_ref) { return a_ref->id; },
+			[](const Ref* a_ref) { return a_ref->base; },
+			[&](RE::TESBoundObject* a_base, RE::TESBoundObject* a_origBase) { return a_world.get_decision(a_base, a_origBase); },
+			a_decisions);
+	}
+
+	//update_base below the batch threshold: each reference misses the memo, is resolved and recorded on its own
+	void memo_per_ref(const World& a_world, const Cell& a_cell, std::uint32_t a_epoch)
+	{
+		const auto memo = SwapMemo::Manager::GetSingleton();
+		for (const auto& ref : a_cell.refs) {
+			if (!memo->Find(ref.id, a_epoch)) {
+				memo->Record(ref.id, a_world.get_decision(ref.base, a_world.get_original_base(ref)), a_epoch);
+			}
+		}
+	}
+
+	//update_base with batching: the cell is resolved and recorded once, then every reference finds its decision
+	void memo_batched(const World& a_world, const Cell& a_cell, std::uint32_t a_epoch, Decisions& a_decisions)
+	{
+		const auto memo = SwapMemo::Manager::GetSingleton();
+
+		decide_batched(a_world, a_cell, a_decisions);
+		memo->Record(a_decisions, a_epoch);
+
+		for (const auto& ref : a_cell.refs) {
+			static_cast<void>(memo->Find(ref.id, a_epoch));
+		}
+	}
+
+	bool same_decisions(const Decisions& a_lhs, const Decisions& a_rhs)
+	{
+		return std::ranges::equal(a_lhs, a_rhs, [](const auto& a_l, const auto& a_r) {
+			return a_l.first == a_r.first && a_l.second.base == a_r.second.base && a_l.second.target == a_r.second.target && a_l.second.recordOriginal == a_r.second.recordOriginal;
+		});
+	}
+
+	//speedup of the batched memo path, or nullopt if the paths disagree
+	std::optional<double> run(std::size_t a_numRefs, std::size_t a_numBases, std::size_t a_iterations)
+	{
+		std::mt19937 rng{ 1234 };
+
+		World world;
+		world.swapTypes.set(24);
+		world.swapTypes.set(36);
+
+		std::vector<Cell> cells;
+		for (std::size_t i = 0; i < 16; ++i) {
+			cells.push_back(make_cell(world, rng, a_numRefs, a_numBases));
+		}
+
+		//both paths must arrive at the same decision for every reference
+		Decisions perRef;
+		Decisions batched;
+		for (const auto& cell : cells) {
+			decide_per_ref(world, cell, perRef);
+			decide_batched(world, cell, batched);
+			std::ranges::sort(batched, {}, &std::pair<RE::FormID, Decision>::first);
+			if (!same_decisions(perRef, batched)) {
+				std::printf("per-ref and batched decisions differ\n");
+				return std::nullopt;
+			}
+		}
+
+		const auto time = [&](auto&& a_func) {
+			clock::duration elapsed{};
+			for (std::size_t i = 0; i < a_iterations; ++i) {
+				//a new season state, the memo starts empty
+				SwapMemo::Manager::GetSingleton()->OnEpochChange(++epoch);
+				const auto start = clock::now();
+				for (const auto& cell : cells) {
+					a_func(cell, epoch);
+				}
+				elapsed += clock::now() - start;
+			}
+			return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(a_numRefs * cells.size() * a_iterations);
+		};
+
+		const auto perRefNs = time([&](const Cell& a_cell, std::uint32_t) { decide_per_ref(world, a_cell, perRef); });
+		const auto batchedNs = time([&](const Cell& a_cell, std::uint32_t) { decide_batched(world, a_cell, batched); });
+		const auto memoPerRefNs = time([&](const Cell& a_cell, std::uint32_t a_epoch) { memo_per_ref(world, a_cell, a_epoch); });
+		const auto memoBatchedNs = time([&](const Cell& a_cell, std::uint32_t a_epoch) { memo_batched(world, a_cell, a_epoch, batched); });
+
+		std::printf("%6zu refs %5zu bases | decide: per-ref %6.1f, batched %6.1f ns/ref (%.2fx) | with memo: per-ref %6.1f, batched %6.1f ns/ref (%.2fx)\n",
+			a_numRefs, a_numBases,
+			perRefNs, batchedNs, perRefNs / batchedNs,
+			memoPerRefNs, memoBatchedNs, memoPerRefNs / memoBatchedNs);
+
+		return memoPerRefNs / memoBatchedNs;
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	std::size_t iterations = 200;
+
+	for (int i = 1; i < a_argc; ++i) {
+		const std::string_view arg{ a_argv[i] };
+		if (arg == "--iterations" && i + 1 < a_argc) {
+			const std::string_view value{ a_argv[++i] };
+			if (std::from_chars(value.data(), value.data() + value.size(), iterations).ec != std::errc{} || iterations == 0) {
+				std::printf("invalid iteration count: %s\n", a_argv[i]);
+				return 1;
+			}
+		}
+	}
+
+	//interior, town exterior, dense exterior, and the large worldspace cells the batching is meant for
+	constexpr std::array<std::pair<std::size_t, std::size_t>, 5> cellSizes{ { { 100, 40 }, { 500, 120 }, { 1500, 300 }, { 4000, 500 }, { 10000, 800 } } };
+
+	//smallest size from which batching kept winning
+	std::optional<std::size_t> breakEven;
+
+	for (const auto& [refs, bases] : cellSizes) {
+		const auto speedup = run(refs, bases, iterations);
+		if (!speedup) {
+			return 1;
+		}
+		if (*speedup > 1.0) {
+			breakEven = breakEven.value_or(refs);
+		} else {
+			breakEven.reset();
+		}
+	}
+
+	if (breakEven) {
+		std::printf("batching won from %zu refs per cell\n", *breakEven);
+	} else {
+		std::printf("batching didn't win at any tested cell size\n");
+	}
+
+	return 0;
+}
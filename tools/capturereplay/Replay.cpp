@@ -0,0 +1,475 @@
+#include "CaptureFormat.h"
+#include "FormIDSet.h"
+#include "SwapLookup.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <latch>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+//Replays a hook capture (po3_SeasonsOfSkyrim_hooks.bin) through the plugin's FormIDSet and swap map lookups,
+//each recorded thread's calls on a thread of their own
+//usage: capturereplay <capture> [--iterations N]
+//       capturereplay --generate <capture> [--records N]
+
+using namespace std::literals;
+
+static_assert(std::endian::native == std::endian::little, "captures are little endian");
+
+namespace
+{
+	using FormID = std::uint32_t;
+	using clock = std::chrono::steady_clock;
+
+	//matches Profiler::HOOK
+	constexpr std::array hookNames{
+		"FormSwap::GetHandle"sv,
+		"LandscapeSwap::Texture::IsConsideredSnow"sv,
+		"LandscapeSwap::Texture::GetSpecularComponent"sv,
+		"LandscapeSwap::Texture::GetAsShaderTextureSet"sv,
+		"LandscapeSwap::Grass::GetGrassList"sv,
+		"LandscapeSwap::Material::GetHavokMaterialType"sv,
+		"SnowSwap::Statics::Clone3D"sv,
+		"SnowSwap::OtherForms::Clone3D"sv,
+		"LODSwap::Terrain"sv,
+		"LODSwap::Object"sv,
+		"LODSwap::Tree"sv
+	};
+
+	//hooks whose record is input FormID -> swap FormID (0 if unchanged)
+	constexpr std::size_t numLookupHooks{ 6 };
+
+	std::string_view get_hook_name(std::uint16_t a_hook)
+	{
+		return a_hook < hookNames.size() ? hookNames[a_hook] : "unknown"sv;
+	}
+
+	struct Capture
+	{
+		::Capture::Header header;
+		std::vector<::Capture::Record> records;
+	};
+
+	std::optional<Capture> load(const std::filesystem::path& a_path)
+	{
+		std::ifstream file{ a_path, std::ios::binary | std::ios::ate };
+		if (!file) {
+			std::printf("couldn't open %s\n", a_path.string().c_str());
+			return std::nullopt;
+		}
+
+		const auto size = static_cast<std::size_t>(file.tellg());
+		file.seekg(0);
+
+		Capture capture;
+		if (size < sizeof(capture.header) || !file.read(reinterpret_cast<char*>(&capture.header), sizeof(capture.header))) {
+			std::printf("%s is too small for a capture header\n", a_path.string().c_str());
+			return std::nullopt;
+		}
+
+		const auto& header = capture.header;
+		if (header.magic != ::Capture::MAGIC) {
+			std::printf("%s is not a hook capture (bad magic)\n", a_path.string().c_str());
+			return std::nullopt;
+		}
+		if (header.version != ::Capture::VERSION) {
+			std::printf("unsupported capture version %u (expected %u)\n", header.version, ::Capture::VERSION);
+			return std::nullopt;
+		}
+		if (header.recordSize != sizeof(::Capture::Record)) {
+			std::printf("unexpected record size %u (expected %zu)\n", header.recordSize, sizeof(::Capture::Record));
+			return std::nullopt;
+		}
+		if (header.hookCount != hookNames.size()) {
+			std::printf("warning: capture has %u hooks, this tool knows %zu\n", header.hookCount, hookNames.size());
+		}
+
+		const auto payload = size - sizeof(header);
+		if (payload % sizeof(::Capture::Record) != 0) {
+			std::printf("warning: dropping a partial record at the end of the file (capture was interrupted)\n");
+		}
+
+		capture.records.resize(payload / sizeof(::Capture::Record));
+		if (!file.read(reinterpret_cast<char*>(capture.records.data()), static_cast<std::streamsize>(capture.records.size() * sizeof(::Capture::Record)))) {
+			std::printf("couldn't read %zu records\n", capture.records.size());
+			return std::nullopt;
+		}
+
+		return capture;
+	}
+
+	void print_summary(const Capture& a_capture)
+	{
+		const auto& records = a_capture.records;
+		if (records.empty()) {
+			std::printf("capture is empty\n");
+			return;
+		}
+
+		const auto [first, last] = std::ranges::minmax(records, {}, &::Capture::Record::timestamp);
+		const auto seconds = static_cast<double>(last.timestamp - first.timestamp) / 1e9;
+
+		std::unordered_set<std::uint32_t> threads;
+		struct HookSummary
+		{
+			std::size_t calls{ 0 };
+			std::size_t swapped{ 0 };
+			std::unordered_set<FormID> inputs;
+		};
+		std::vector<HookSummary> hooks(std::max<std::size_t>(hookNames.size(), a_capture.header.hookCount));
+
+		for (const auto& record : records) {
+			threads.insert(record.threadID);
+			if (record.hook >= hooks.size()) {
+				hooks.resize(record.hook + 1);
+			}
+			auto& hook = hooks[record.hook];
+			++hook.calls;
+			hook.inputs.insert(record.input);
+			if (record.hook < numLookupHooks ? record.output != 0 : record.flags != 0) {
+				++hook.swapped;
+			}
+		}
+
+		std::printf("%zu calls over %.3f s from %zu threads\n", records.size(), seconds, threads.size());
+		std::printf("%-48s %10s %10s %10s %10s\n", "hook", "calls", "calls/s", "inputs", "swapped");
+		for (std::uint16_t i = 0; i < hooks.size(); ++i) {
+			const auto& hook = hooks[i];
+			if (hook.calls == 0) {
+				continue;
+			}
+			std::printf("%-48.*s %10zu %10.0f %10zu %10zu\n",
+				static_cast<int>(get_hook_name(i).size()), get_hook_name(i).data(),
+				hook.calls, seconds > 0.0 ? hook.calls / seconds : 0.0, hook.inputs.size(), hook.swapped);
+		}
+	}
+
+	struct Lookup
+	{
+		std::uint16_t hook;
+		FormID input;
+		FormID output;
+	};
+
+	using Stream = std::vector<Lookup>;
+
+	[[nodiscard]] std::uint64_t make_key(std::uint16_t a_hook, FormID a_formID)
+	{
+		return (static_cast<std::uint64_t>(a_hook) << 32) | a_formID;
+	}
+
+	//the plugin's lookup structures, rebuilt from the swaps seen in the capture.
+	//GetHandle checks CellIndex's base and target set before the form swap map, landscape hooks go straight to the swap map
+	class Tables
+	{
+	public:
+		Tables(const std::vector<Lookup>& a_swaps, bool a_prefilter) :
+			_prefilter(a_prefilter)
+		{
+			for (const auto& [hook, input, output] : a_swaps) {
+				_maps[hook].emplace(input, output);
+				if (hook == 0) {
+					_swapBasesAndTargets.insert(input);
+					_swapBasesAndTargets.insert(output);
+				}
+			}
+		}
+
+		[[nodiscard]] FormID find(std::uint16_t a_hook, FormID a_input) const
+		{
+			if (a_hook == 0 && _prefilter && !_swapBasesAndTargets.contains(a_input)) {
+				return 0;
+			}
+			return SwapLookup::find(_maps[a_hook], a_input);
+		}
+
+	private:
+		std::array<MapPair<FormID>, numLookupHooks> _maps{};
+		FormIDSet _swapBasesAndTargets{};
+		bool _prefilter;
+	};
+
+	std::uint64_t replay_stream(const Tables& a_tables, const Stream& a_stream, std::size_t a_iterations)
+	{
+		std::uint64_t checksum = 0;
+		for (std::size_t i = 0; i < a_iterations; ++i) {
+			for (const auto& lookup : a_stream) {
+				checksum += a_tables.find(lookup.hook, lookup.input);
+			}
+		}
+		return checksum;
+	}
+
+	//each recorded thread's stream on its own thread, released together, against the shared tables
+	template <bool Threaded>
+	std::uint64_t time_tables(std::string_view a_name, const std::vector<Lookup>& a_swaps, bool a_prefilter, const std::vector<Stream>& a_streams, std::size_t a_iterations)
+	{
+		const auto buildStart = clock::now();
+		const Tables tables{ a_swaps, a_prefilter };
+		const auto buildTime = std::chrono::duration<double, std::micro>(clock::now() - buildStart).count();
+
+		std::size_t numLookups = 0;
+		for (const auto& stream : a_streams) {
+			numLookups += stream.size();
+		}
+
+		std::vector<std::uint64_t> checksums(a_streams.size());
+		std::vector<double> threadTimes(a_streams.size());
+
+		const auto run = [&](std::size_t a_index) {
+			const auto start = clock::now();
+			checksums[a_index] = replay_stream(tables, a_streams[a_index], a_iterations);
+			threadTimes[a_index] = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+		};
+
+		const auto start = clock::now();
+		if constexpr (Threaded) {
+			std::latch ready{ static_cast<std::ptrdiff_t>(a_streams.size()) };
+			std::vector<std::jthread> threads;
+			threads.reserve(a_streams.size());
+			for (std::size_t i = 0; i < a_streams.size(); ++i) {
+				threads.emplace_back([&, i] {
+					ready.arrive_and_wait();
+					run(i);
+				});
+			}
+		} else {
+			for (std::size_t i = 0; i < a_streams.size(); ++i) {
+				run(i);
+			}
+		}
+		const auto elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+
+		double slowest = 0.0;
+		for (std::size_t i = 0; i < a_streams.size(); ++i) {
+			if (!a_streams[i].empty()) {
+				slowest = std::max(slowest, threadTimes[i] / static_cast<double>(a_streams[i].size() * a_iterations));
+			}
+		}
+
+		std::printf("%-24.*s build %10.1f us | wall %10.2f ms | %8.2f ns/lookup | slowest thread %8.2f ns/lookup\n",
+			static_cast<int>(a_name.size()), a_name.data(), buildTime, elapsed / 1e6, elapsed / static_cast<double>(numLookups * a_iterations), slowest);
+
+		std::uint64_t checksum = 0;
+		for (const auto value : checksums) {
+			checksum += value;
+		}
+		return checksum;
+	}
+
+	bool replay(const Capture& a_capture, std::size_t a_iterations)
+	{
+		//recorded order within each thread
+		std::map<std::uint32_t, Stream> threadStreams;
+		std::vector<Lookup> lookups;
+		for (const auto& record : a_capture.records) {
+			if (record.hook < numLookupHooks) {
+				threadStreams[record.threadID].push_back({ record.hook, record.input, record.output });
+				lookups.push_back({ record.hook, record.input, record.output });
+			}
+		}
+		if (lookups.empty()) {
+			std::printf("no FormID lookups to replay\n");
+			return true;
+		}
+
+		std::vector<Stream> streams;
+		streams.reserve(threadStreams.size());
+		for (auto& [threadID, stream] : threadStreams) {
+			streams.push_back(std::move(stream));
+		}
+
+		//last observed result per input, inputs can change result when the season changes mid capture
+		std::unordered_map<std::uint64_t, FormID> latest;
+		std::unordered_set<std::uint64_t> changed;
+		std::size_t repeats = 0;
+		for (const auto& [hook, input, output] : lookups) {
+			const auto [it, inserted] = latest.try_emplace(make_key(hook, input), output);
+			if (!inserted) {
+				++repeats;
+				if (it->second != output) {
+					changed.insert(it->first);
+					it->second = output;
+				}
+			}
+		}
+
+		std::vector<Lookup> swaps;
+		for (const auto& [key, output] : latest) {
+			if (output != 0) {
+				swaps.push_back({ static_cast<std::uint16_t>(key >> 32), static_cast<FormID>(key), output });
+			}
+		}
+
+		//keys that never changed must replay to the recorded result
+		std::size_t mismatches = 0;
+		{
+			const Tables tables{ swaps, true };
+			for (const auto& lookup : lookups) {
+				if (!changed.contains(make_key(lookup.hook, lookup.input)) && tables.find(lookup.hook, lookup.input) != lookup.output) {
+					++mismatches;
+				}
+			}
+		}
+
+		std::printf("\nreplaying %zu lookups x %zu from %zu threads | %zu keys, %zu swapped | %.1f%% repeat lookups | %zu keys changed result during the capture\n",
+			lookups.size(), a_iterations, streams.size(), latest.size(), swaps.size(), 100.0 * static_cast<double>(repeats) / static_cast<double>(lookups.size()), changed.size());
+
+		const auto mapSerial = time_tables<false>("swap map, serial", swaps, false, streams, a_iterations);
+		const auto mapThreaded = time_tables<true>("swap map, threaded", swaps, false, streams, a_iterations);
+		const auto filteredSerial = time_tables<false>("prefiltered, serial", swaps, true, streams, a_iterations);
+		const auto filteredThreaded = time_tables<true>("prefiltered, threaded", swaps, true, streams, a_iterations);
+
+		if (mapSerial != mapThreaded || mapSerial != filteredSerial || mapSerial != filteredThreaded) {
+			std::printf("replays disagree\n");
+			return false;
+		}
+		if (mismatches != 0) {
+			std::printf("%zu replayed results don't match the capture\n", mismatches);
+			return false;
+		}
+		return true;
+	}
+
+	//plugins, a light plugin, a season change halfway through, and skewed access like cell loads
+	bool generate(const std::filesystem::path& a_path, std::size_t a_numRecords)
+	{
+		std::mt19937 rng{ 1234 };
+
+		std::vector<FormID> bases;
+		for (FormID plugin : { 0x00000000u, 0x01000000u, 0x02000000u, 0x05000000u }) {
+			for (FormID i = 0; i < 1500; ++i) {
+				bases.push_back(plugin | (0x800 + static_cast<FormID>(rng() % 0x40000)));
+			}
+		}
+		for (FormID i = 0; i < 500; ++i) {
+			bases.push_back(0xFE000000u | ((rng() % 8) << 12) | (0x800 + static_cast<FormID>(rng() % 0x700)));
+		}
+
+		std::unordered_map<FormID, std::array<FormID, 2>> swaps;
+		for (const auto base : bases) {
+			if (rng() % 5 == 0) {
+				swaps[base] = { base ^ 0x00100000u, rng() % 2 ? base ^ 0x00200000u : 0 };
+			}
+		}
+
+		std::vector<FormID> landTextures;
+		for (FormID i = 0; i < 200; ++i) {
+			landTextures.push_back(0x00000C00u + i * 3);
+		}
+
+		std::geometric_distribution<std::size_t> skew{ 0.002 };
+		const std::array<std::uint32_t, 4> threads{ 1000, 1004, 1008, 1012 };
+
+		std::vector<::Capture::Record> records;
+		records.reserve(a_numRecords);
+		for (std::size_t i = 0; i < a_numRecords; ++i) {
+			const std::size_t season = i < a_numRecords / 2 ? 0 : 1;
+
+			::Capture::Record record{};
+			record.timestamp = i * 2500;
+			record.threadID = threads[rng() % threads.size()];
+
+			const auto kind = rng() % 10;
+			if (kind < 6) {
+				const auto base = bases[skew(rng) % bases.size()];
+				const auto it = swaps.find(base);
+				record.hook = 0;
+				record.input = base;
+				record.output = it != swaps.end() ? it->second[season] : 0;
+			} else if (kind < 9) {
+				const auto landTexture = landTextures[skew(rng) % landTextures.size()];
+				record.hook = static_cast<std::uint16_t>(1 + rng() % 5);
+				record.input = landTexture;
+				record.output = landTexture % 2 ? landTexture + 1 + static_cast<FormID>(season) : 0;
+			} else {
+				record.hook = static_cast<std::uint16_t>(6 + rng() % 5);
+				record.input = bases[rng() % bases.size()];
+				record.output = record.hook < 8 ? 0xFF000800u + static_cast<FormID>(i) : 0;
+				record.flags = record.hook >= 8 ? static_cast<std::uint16_t>(rng() % 2) : 0;
+				record.x = static_cast<std::int16_t>(rng() % 64) - 32;
+				record.y = static_cast<std::int16_t>(rng() % 64) - 32;
+				record.scale = 4u << (rng() % 3);
+			}
+			records.push_back(record);
+		}
+
+		std::ofstream file{ a_path, std::ios::binary | std::ios::trunc };
+		if (!file) {
+			std::printf("couldn't open %s\n", a_path.string().c_str());
+			return false;
+		}
+
+		const ::Capture::Header header{ .recordSize = sizeof(::Capture::Record), .hookCount = static_cast<std::uint32_t>(hookNames.size()) };
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(::Capture::Record)));
+
+		std::printf("wrote %zu records to %s\n", records.size(), a_path.string().c_str());
+		return static_cast<bool>(file);
+	}
+
+	bool parse_count(std::string_view a_value, std::size_t& a_count)
+	{
+		return std::from_chars(a_value.data(), a_value.data() + a_value.size(), a_count).ec == std::errc{} && a_count > 0;
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	std::filesystem::path path;
+	std::filesystem::path generatePath;
+	std::size_t iterations = 10;
+	std::size_t numRecords = 500000;
+
+	for (int i = 1; i < a_argc; ++i) {
+		const std::string_view arg{ a_argv[i] };
+		const bool hasValue = i + 1 < a_argc;
+		if (arg == "--iterations" && hasValue) {
+			if (!parse_count(a_argv[++i], iterations)) {
+				std::printf("invalid iteration count: %s\n", a_argv[i]);
+				return 1;
+			}
+		} else if (arg == "--records" && hasValue) {
+			if (!parse_count(a_argv[++i], numRecords)) {
+				std::printf("invalid record count: %s\n", a_argv[i]);
+				return 1;
+			}
+		} else if (arg == "--generate" && hasValue) {
+			generatePath = a_argv[++i];
+		} else {
+			path = arg;
+		}
+	}
+
+	if (!generatePath.empty()) {
+		return generate(generatePath, numRecords) ? 0 : 1;
+	}
+
+	if (path.empty()) {
+		std::printf("usage: capturereplay <capture> [--iterations N]\n       capturereplay --generate <capture> [--records N]\n");
+		return 1;
+	}
+
+	const auto capture = load(path);
+	if (!capture) {
+		return 1;
+	}
+
+	print_summary(*capture);
+	return replay(*capture, iterations) ? 0 : 1;
+}